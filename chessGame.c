@@ -189,6 +189,18 @@ PlayerPresent getPlayerGameResult(ChessGame game, int player)
     ||(game->player2ID == first_player && game->player1ID == second_player);
 }
 
+MapKeyElement gameProjectFirstPlayer(MapKeyElement game_key, MapDataElement game)
+{
+    (void)game_key;
+    return &((ChessGame)game)->player1ID;
+}
+
+MapKeyElement gameProjectSecondPlayer(MapKeyElement game_key, MapDataElement game)
+{
+    (void)game_key;
+    return &((ChessGame)game)->player2ID;
+}
+
  ChessResult checkValidPlayTime(int play_time)
 {
     if(play_time < 0)
@@ -198,3 +210,24 @@ PlayerPresent getPlayerGameResult(ChessGame game, int player)
     return CHESS_SUCCESS;
 
 }
+
+void gameSaveSnapshot(ChessGame game, SnapshotWriter writer)
+{
+    snapshotPutInt(writer, game->player1ID);
+    snapshotPutInt(writer, game->player2ID);
+    snapshotPutInt(writer, game->gameDuration);
+    snapshotPutInt(writer, game->result);
+}
+
+ChessGame gameLoadSnapshot(SnapshotReader reader)
+{
+    int first_player = snapshotGetInt(reader);
+    int second_player = snapshotGetInt(reader);
+    int duration = snapshotGetInt(reader);
+    int result = snapshotGetInt(reader);
+    if (result != FIRST_PLAYER && result != SECOND_PLAYER && result != DRAW)
+    {
+        return NULL;
+    }
+    return gameCreate(first_player, second_player, duration, (Winner)result);
+}
@@ -2,6 +2,8 @@
 #ifndef _CHESS_GAME_H
 #define _CHESS_GAME_H
 #include "./chessPlayerStats.h"
+#include "./mtm_map/map.h"
+#include "./chessSnapshot.h"
 #include <stdbool.h>
 
 /* ----------------------------------------------------------------------
@@ -117,6 +119,24 @@ ChessGame gameCreate(int first_player, int second_player, int duration, Winner r
  */
 ChessResult checkGameVaraiables(int tournament_id, int first_player, int second_player);
 
+/**
+ * @brief Projects a game onto its first player's id(used as a games map index projection)
+ * 
+ * @param game_key 
+ * @param game 
+ * @return MapKeyElement - pointer to the game's first player id
+ */
+MapKeyElement gameProjectFirstPlayer(MapKeyElement game_key, MapDataElement game);
+
+/**
+ * @brief Projects a game onto its second player's id(used as a games map index projection)
+ * 
+ * @param game_key 
+ * @param game 
+ * @return MapKeyElement - pointer to the game's second player id
+ */
+MapKeyElement gameProjectSecondPlayer(MapKeyElement game_key, MapDataElement game);
+
 /**
  * @brief Checks if given play time is valid
  * 
@@ -124,6 +144,22 @@ ChessResult checkGameVaraiables(int tournament_id, int first_player, int second_
  * @return ChessResult 
  */
 ChessResult checkValidPlayTime(int play_time);
+
+/**
+ * @brief Writes a game's details to a snapshot
+ * 
+ * @param game 
+ * @param writer 
+ */
+void gameSaveSnapshot(ChessGame game, SnapshotWriter writer);
+
+/**
+ * @brief Creates a game from the details written by gameSaveSnapshot
+ * 
+ * @param reader 
+ * @return ChessGame(NULL if the allocation failed or the snapshot holds no valid game)
+ */
+ChessGame gameLoadSnapshot(SnapshotReader reader);
  
 
 #endif 
\ No newline at end of file
@@ -3,6 +3,40 @@
 #include "./chessId.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#define ID_SET_MIN_CAPACITY 4
+
+/* ----------------------------------------------------------------------
+
+                         Data structs defenitions
+
+------------------------------------------------------------------------*/
+/** Struct used for holding a set of ids
+ * @param ids - the set's ids in ascending order
+ * @param size - amount of ids in the set
+ * @param capacity - amount of ids the array has room for
+ */
+struct id_set_t
+{
+    int* ids;
+    int size;
+    int capacity;
+};
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Finds the position of the first id of a set that is not smaller than a given id(binary search)
+ * 
+ * @param set 
+ * @param id 
+ * @return The position(the set's size if all its ids are smaller)
+ */
+static int idSetLowerBound(IdSet set, int id);
 
 /* ----------------------------------------------------------------------
 
@@ -25,4 +59,122 @@
  void freeIdKey(MapKeyElement id_key)
 {
     free(id_key);
-}
\ No newline at end of file
+}
+
+ unsigned int hashIdKey(MapKeyElement id_key)
+{
+    return (unsigned int)*(int *)id_key;
+}
+
+ IdSet idSetCreate()
+{
+    IdSet set = malloc(sizeof(struct id_set_t));
+    CHECK_NULL_RETURN(set);
+    set->ids = malloc(sizeof(int) * ID_SET_MIN_CAPACITY);
+    if (set->ids == NULL)
+    {
+        free(set);
+        return NULL;
+    }
+    set->size = 0;
+    set->capacity = ID_SET_MIN_CAPACITY;
+    return set;
+}
+
+ IdSet idSetCopy(IdSet set)
+{
+    CHECK_NULL_RETURN(set);
+    IdSet new_set = malloc(sizeof(struct id_set_t));
+    CHECK_NULL_RETURN(new_set);
+    new_set->ids = malloc(sizeof(int) * set->capacity);
+    if (new_set->ids == NULL)
+    {
+        free(new_set);
+        return NULL;
+    }
+    memcpy(new_set->ids, set->ids, sizeof(int) * set->size);
+    new_set->size = set->size;
+    new_set->capacity = set->capacity;
+    return new_set;
+}
+
+ void idSetDestroy(IdSet set)
+{
+    if (set != NULL)
+    {
+        free(set->ids);
+        free(set);
+    }
+}
+
+ bool idSetAdd(IdSet set, int id)
+{
+    if (set == NULL)
+    {
+        return false;
+    }
+    int position = idSetLowerBound(set, id);
+    if (position < set->size && set->ids[position] == id)
+    {
+        return true;
+    }
+    if (set->size == set->capacity)
+    {
+        int* ids = realloc(set->ids, sizeof(int) * set->capacity * 2);
+        if (ids == NULL)
+        {
+            return false;
+        }
+        set->ids = ids;
+        set->capacity *= 2;
+    }
+    memmove(&set->ids[position + 1], &set->ids[position], sizeof(int) * (set->size - position));
+    set->ids[position] = id;
+    set->size++;
+    return true;
+}
+
+ void idSetRemove(IdSet set, int id)
+{
+    CHECK_NULL_VOID(set);
+    int position = idSetLowerBound(set, id);
+    if (position < set->size && set->ids[position] == id)
+    {
+        memmove(&set->ids[position], &set->ids[position + 1], sizeof(int) * (set->size - position - 1));
+        set->size--;
+    }
+}
+
+ int idSetGetSize(IdSet set)
+{
+    return (set == NULL) ? 0 : set->size;
+}
+
+ int idSetGet(IdSet set, int position)
+{
+    return set->ids[position];
+}
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions defenitions
+
+------------------------------------------------------------------------*/
+static int idSetLowerBound(IdSet set, int id)
+{
+    int low = 0;
+    int high = set->size;
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (set->ids[middle] < id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
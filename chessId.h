@@ -24,5 +24,72 @@
   * @param id_key 
   */
  void freeIdKey(MapKeyElement id_key);
+
+ /**
+  * @brief Hash function for id keys(presented as int*). Used for the maps' lookup filter
+  * 
+  * @param id_key 
+  * @return Hash value of the id
+  */
+ unsigned int hashIdKey(MapKeyElement id_key);
+
+ /** Type for a small set of ids kept as a sorted array(meant for a few ids, such as the tournaments of a player) */
+ typedef struct id_set_t *IdSet;
+
+ /**
+  * @brief Creates an empty set of ids
+  * 
+  * @return A new set(NULL if allocation failed)
+  */
+ IdSet idSetCreate();
+
+ /**
+  * @brief Copies a set of ids. Used as the maps' copy function for sets
+  * 
+  * @param set 
+  * @return A new copy of the set(NULL if set is NULL or allocation failed)
+  */
+ IdSet idSetCopy(IdSet set);
+
+ /**
+  * @brief Frees a set of ids. Used as the maps' free function for sets
+  * 
+  * @param set 
+  */
+ void idSetDestroy(IdSet set);
+
+ /**
+  * @brief Adds an id to a set(nothing is done if it is already in it). Takes time linear in the size of the set
+  * 
+  * @param set 
+  * @param id 
+  * @return false if set is NULL or allocation failed, true otherwise
+  */
+ bool idSetAdd(IdSet set, int id);
+
+ /**
+  * @brief Removes an id from a set(nothing is done if it is not in it)
+  * 
+  * @param set 
+  * @param id 
+  */
+ void idSetRemove(IdSet set, int id);
+
+ /**
+  * @brief Returns the amount of ids in a set
+  * 
+  * @param set 
+  * @return Amount of ids(0 if set is NULL)
+  */
+ int idSetGetSize(IdSet set);
+
+ /**
+  * @brief Returns the id at a given position of a set, ids being in ascending order
+  * 
+  * @param set 
+  * @param position between 0 and the set's size - 1
+  * @return The id at the position
+  */
+ int idSetGet(IdSet set, int position);
  
  #endif
\ No newline at end of file
@@ -0,0 +1,218 @@
+#define _POSIX_C_SOURCE 200809L
+#include "./chessImport.h"
+#include "./chessReturnsMacros.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+/* ----------------------------------------------------------------------
+
+                         Import required constants
+
+------------------------------------------------------------------------*/
+#define IMPORT_FIELDS 5
+#define IMPORT_MAX_DIGITS 10
+#define DECIMAL_BASE 10
+#define NANOSECONDS_IN_SECOND 1e9
+/* ----------------------------------------------------------------------
+
+                         Data structs defenitions
+
+------------------------------------------------------------------------*/
+/** Struct used for pointing at a mapped games file's details
+ * @param data - the file's contents(NULL if the file is empty)
+ * @param size - the file's size in bytes
+ * @param position - offset of the next line
+ * @param line_number - number of the line read last
+ * @param start - when the file was opened
+ */
+struct import_file_t
+{
+    const char *data;
+    long size;
+    long position;
+    long line_number;
+    struct timespec start;
+};
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Skips the separators(spaces, tabs, commas and carriage returns) at a given position of a line
+ *
+ * @param current
+ * @param line_end
+ * @return The position of the first character that is not a separator(line_end if there is none)
+ */
+static const char *importSkipSeparators(const char *current, const char *line_end);
+
+/**
+ * @brief Scans a decimal integer at a given position of a line
+ *
+ * @param current
+ * @param line_end
+ * @param value - filled with the integer scanned
+ * @return The position right after the integer(NULL if there is no integer there, or it does not fit an int)
+ */
+static const char *importScanInt(const char *current, const char *line_end, int *value);
+
+/* ----------------------------------------------------------------------
+
+                 Header included functions defenitions
+
+------------------------------------------------------------------------*/
+ImportFile importOpen(const char* path_file)
+{
+    CHECK_NULL_RETURN(path_file);
+    ImportFile new_file = malloc(sizeof(struct import_file_t));
+    CHECK_NULL_RETURN(new_file);
+    clock_gettime(CLOCK_MONOTONIC, &new_file->start);
+    new_file->data = NULL;
+    new_file->size = 0;
+    new_file->position = 0;
+    new_file->line_number = 0;
+
+    int descriptor = open(path_file, O_RDONLY);
+    struct stat file_status;
+    if (descriptor < 0 || fstat(descriptor, &file_status) != 0)
+    {
+        if (descriptor >= 0)
+        {
+            close(descriptor);
+        }
+        free(new_file);
+        return NULL;
+    }
+    new_file->size = file_status.st_size;
+    if (new_file->size > 0)
+    {
+        void *data = mmap(NULL, new_file->size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (data == MAP_FAILED)
+        {
+            close(descriptor);
+            free(new_file);
+            return NULL;
+        }
+        posix_madvise(data, new_file->size, POSIX_MADV_SEQUENTIAL);
+        new_file->data = data;
+    }
+    close(descriptor);
+    return new_file;
+}
+
+ImportLine importNextGame(ImportFile file, ChessGameRecord* game)
+{
+    if (file->position >= file->size)
+    {
+        return IMPORT_END;
+    }
+    const char *current = file->data + file->position;
+    const char *file_end = file->data + file->size;
+    const char *line_end = memchr(current, '\n', file_end - current);
+    if (line_end == NULL)
+    {
+        line_end = file_end;
+    }
+    file->position = (line_end - file->data) + 1;
+    file->line_number++;
+
+    current = importSkipSeparators(current, line_end);
+    if (current == line_end)
+    {
+        return IMPORT_EMPTY_LINE;
+    }
+    int fields[IMPORT_FIELDS];
+    int amount = 0;
+    while (current != line_end && amount < IMPORT_FIELDS)
+    {
+        current = importScanInt(current, line_end, &fields[amount++]);
+        if (current == NULL)
+        {
+            return IMPORT_INVALID_LINE;
+        }
+        current = importSkipSeparators(current, line_end);
+    }
+    if (amount != IMPORT_FIELDS || current != line_end || fields[3] < FIRST_PLAYER || fields[3] > DRAW)
+    {
+        return IMPORT_INVALID_LINE;
+    }
+
+    game->tournament_id = fields[0];
+    game->first_player = fields[1];
+    game->second_player = fields[2];
+    game->winner = (Winner)fields[3];
+    game->play_time = fields[4];
+    return IMPORT_GAME;
+}
+
+long importGetLineNumber(ImportFile file)
+{
+    return file->line_number;
+}
+
+long importGetSize(ImportFile file)
+{
+    return file->size;
+}
+
+double importGetElapsedSeconds(ImportFile file)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - file->start.tv_sec) + (now.tv_nsec - file->start.tv_nsec) / NANOSECONDS_IN_SECOND;
+}
+
+void importClose(ImportFile file)
+{
+    if (file != NULL)
+    {
+        if (file->data != NULL)
+        {
+            munmap((void *)file->data, file->size);
+        }
+        free(file);
+    }
+}
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions defenitions
+
+------------------------------------------------------------------------*/
+static const char *importSkipSeparators(const char *current, const char *line_end)
+{
+    while (current != line_end && (*current == ' ' || *current == ',' || *current == '\t' || *current == '\r'))
+    {
+        current++;
+    }
+    return current;
+}
+
+static const char *importScanInt(const char *current, const char *line_end, int *value)
+{
+    bool negative = (*current == '-');
+    current += negative;
+    const char *digits_start = current;
+    const char *digits_end = (line_end - current > IMPORT_MAX_DIGITS) ? current + IMPORT_MAX_DIGITS + 1 : line_end;
+    long long magnitude = 0;
+    unsigned digit;
+    while (current != digits_end && (digit = (unsigned)(*current - '0')) < DECIMAL_BASE)
+    {
+        magnitude = magnitude * DECIMAL_BASE + digit;
+        current++;
+    }
+    if (current == digits_start || current - digits_start > IMPORT_MAX_DIGITS || magnitude > INT_MAX)
+    {
+        return NULL;
+    }
+    *value = negative ? -(int)magnitude : (int)magnitude;
+    return current;
+}
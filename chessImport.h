@@ -0,0 +1,91 @@
+#ifndef _CHESS_IMPORT_H
+#define _CHESS_IMPORT_H
+#include "./chessSystem.h"
+
+/* ----------------------------------------------------------------------
+
+                         Games file format
+
+------------------------------------------------------------------------*/
+/*
+ * A games file holds a game per line: tournament_id first_player second_player winner play_time
+ * The fields are decimal integers(optionally negative), separated by spaces, tabs or commas.
+ * winner is 0 for FIRST_PLAYER, 1 for SECOND_PLAYER and 2 for DRAW. Lines end with "\n" or "\r\n",
+ * and empty lines are skipped.
+ */
+
+/* ----------------------------------------------------------------------
+
+                         Data structs declerations
+
+------------------------------------------------------------------------*/
+/** A games file mapped to memory, read a line at a time */
+typedef struct import_file_t *ImportFile;
+
+/** The kinds of lines a games file holds */
+typedef enum
+{
+    IMPORT_GAME,
+    IMPORT_EMPTY_LINE,
+    IMPORT_INVALID_LINE,
+    IMPORT_END
+} ImportLine;
+
+/* ----------------------------------------------------------------------
+
+                         Header functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Maps a games file to memory for reading(and starts timing the import)
+ *
+ * @param path_file
+ * @return ImportFile(NULL if the file could not be opened or mapped, or an allocation failed)
+ */
+ImportFile importOpen(const char* path_file);
+
+/**
+ * @brief Reads the next line of a games file
+ *
+ * @param file
+ * @param game - filled with the line's game(if it holds one)
+ * @return
+ * IMPORT_GAME - if the line holds a game
+ * IMPORT_EMPTY_LINE - if the line holds nothing but separators
+ * IMPORT_INVALID_LINE - if the line is not five integers, an integer is too large, or winner is invalid
+ * IMPORT_END - if the whole file was read
+ */
+ImportLine importNextGame(ImportFile file, ChessGameRecord* game);
+
+/**
+ * @brief Returns the number of the line importNextGame read last(the first line is 1)
+ *
+ * @param file
+ * @return long
+ */
+long importGetLineNumber(ImportFile file);
+
+/**
+ * @brief Returns a games file's size in bytes
+ *
+ * @param file
+ * @return long
+ */
+long importGetSize(ImportFile file);
+
+/**
+ * @brief Returns the time in seconds passed since a games file was opened
+ *
+ * @param file
+ * @return double
+ */
+double importGetElapsedSeconds(ImportFile file);
+
+/**
+ * @brief Unmaps a games file and frees it
+ *
+ * @param file
+ */
+void importClose(ImportFile file);
+
+#endif
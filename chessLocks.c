@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 200809L
+#include "./chessLocks.h"
+#include "./chessReturnsMacros.h"
+#include <stdlib.h>
+#include <pthread.h>
+/* ----------------------------------------------------------------------
+
+                         Data structs defenitions
+
+------------------------------------------------------------------------*/
+/** Struct used for pointing at a thread safe chess system's locks(see the lock ordering in chessLocks.h)
+ * @param catalog
+ * @param players
+ * @param stripes
+ * @param levels
+ * @param log
+ */
+struct chess_locks_t
+{
+    pthread_rwlock_t catalog;
+    pthread_rwlock_t players;
+    pthread_mutex_t stripes[LOCKS_PLAYER_STRIPES];
+    pthread_mutex_t levels;
+    pthread_mutex_t log;
+};
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Returns the stripe a player's id belongs to
+ *
+ * @param player_id
+ * @return int
+ */
+static int locksGetStripe(int player_id);
+
+/* ----------------------------------------------------------------------
+
+                 Header included functions defenitions
+
+------------------------------------------------------------------------*/
+ChessLocks locksCreate(void)
+{
+    ChessLocks new_locks = malloc(sizeof(struct chess_locks_t));
+    CHECK_NULL_RETURN(new_locks);
+    pthread_rwlock_init(&new_locks->catalog, NULL);
+    pthread_rwlock_init(&new_locks->players, NULL);
+    for (int i = 0; i < LOCKS_PLAYER_STRIPES; i++)
+    {
+        pthread_mutex_init(&new_locks->stripes[i], NULL);
+    }
+    pthread_mutex_init(&new_locks->levels, NULL);
+    pthread_mutex_init(&new_locks->log, NULL);
+    return new_locks;
+}
+
+void locksDestroy(ChessLocks locks)
+{
+    CHECK_NULL_VOID(locks);
+    pthread_rwlock_destroy(&locks->catalog);
+    pthread_rwlock_destroy(&locks->players);
+    for (int i = 0; i < LOCKS_PLAYER_STRIPES; i++)
+    {
+        pthread_mutex_destroy(&locks->stripes[i]);
+    }
+    pthread_mutex_destroy(&locks->levels);
+    pthread_mutex_destroy(&locks->log);
+    free(locks);
+}
+
+void locksLockCatalog(ChessLocks locks, bool exclusive)
+{
+    CHECK_NULL_VOID(locks);
+    if (exclusive)
+    {
+        pthread_rwlock_wrlock(&locks->catalog);
+    }
+    else
+    {
+        pthread_rwlock_rdlock(&locks->catalog);
+    }
+}
+
+void locksUnlockCatalog(ChessLocks locks)
+{
+    CHECK_NULL_VOID(locks);
+    pthread_rwlock_unlock(&locks->catalog);
+}
+
+void locksLockTournament(ChessLocks locks, ChessTournament tournament)
+{
+    CHECK_NULL_VOID(locks);
+    tournamentLock(tournament);
+}
+
+void locksUnlockTournament(ChessLocks locks, ChessTournament tournament)
+{
+    CHECK_NULL_VOID(locks);
+    tournamentUnlock(tournament);
+}
+
+void locksLockPlayers(ChessLocks locks, bool exclusive)
+{
+    CHECK_NULL_VOID(locks);
+    if (exclusive)
+    {
+        pthread_rwlock_wrlock(&locks->players);
+    }
+    else
+    {
+        pthread_rwlock_rdlock(&locks->players);
+    }
+}
+
+void locksUnlockPlayers(ChessLocks locks)
+{
+    CHECK_NULL_VOID(locks);
+    pthread_rwlock_unlock(&locks->players);
+}
+
+void locksLockStripes(ChessLocks locks, int first_player, int second_player)
+{
+    CHECK_NULL_VOID(locks);
+    int first_stripe = locksGetStripe(first_player);
+    int second_stripe = locksGetStripe(second_player);
+    int lower = (first_stripe < second_stripe) ? first_stripe : second_stripe;
+    int higher = (first_stripe < second_stripe) ? second_stripe : first_stripe;
+    pthread_mutex_lock(&locks->stripes[lower]);
+    if (higher != lower)
+    {
+        pthread_mutex_lock(&locks->stripes[higher]);
+    }
+}
+
+void locksUnlockStripes(ChessLocks locks, int first_player, int second_player)
+{
+    CHECK_NULL_VOID(locks);
+    int first_stripe = locksGetStripe(first_player);
+    int second_stripe = locksGetStripe(second_player);
+    pthread_mutex_unlock(&locks->stripes[first_stripe]);
+    if (second_stripe != first_stripe)
+    {
+        pthread_mutex_unlock(&locks->stripes[second_stripe]);
+    }
+}
+
+void locksLockLevels(ChessLocks locks)
+{
+    CHECK_NULL_VOID(locks);
+    pthread_mutex_lock(&locks->levels);
+}
+
+void locksUnlockLevels(ChessLocks locks)
+{
+    CHECK_NULL_VOID(locks);
+    pthread_mutex_unlock(&locks->levels);
+}
+
+void locksLockLog(ChessLocks locks)
+{
+    CHECK_NULL_VOID(locks);
+    pthread_mutex_lock(&locks->log);
+}
+
+void locksUnlockLog(ChessLocks locks)
+{
+    CHECK_NULL_VOID(locks);
+    pthread_mutex_unlock(&locks->log);
+}
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions defenitions
+
+------------------------------------------------------------------------*/
+static int locksGetStripe(int player_id)
+{
+    return (int)((unsigned int)player_id % LOCKS_PLAYER_STRIPES);
+}
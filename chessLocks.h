@@ -0,0 +1,148 @@
+#ifndef _CHESS_LOCKS_H
+#define _CHESS_LOCKS_H
+#include <stdbool.h>
+#include "./chessTournament.h"
+
+/* ----------------------------------------------------------------------
+
+                         Lock ordering
+
+------------------------------------------------------------------------*/
+/*
+ * A thread safe chess system is guarded by these locks, always taken in this order(and released in reverse):
+ *   1. catalog    - reader-writer lock over the system's tournaments map. Taken exclusively by every call that
+ *                   adds or removes tournaments or walks the whole system; shared by the calls that work on a
+ *                   single tournament or player
+ *   2. tournament - each tournament's own lock(see tournamentLock), taken under a shared catalog. At most one
+ *                   tournament is held at a time
+ *   3. players    - reader-writer lock over the structure of the players system stats and players tournaments
+ *                   maps. Shared while updating existing players, exclusive while adding new ones
+ *   4. stripes    - a lock per group of player ids(id modulo LOCKS_PLAYER_STRIPES), guarding the players' system
+ *                   stats and tournament ids. Both players of a game are locked in ascending stripe order
+ *   5. levels     - lock over the players levels order, held while a player's system stats change
+ *   6. log        - lock over the system's log and its sequence
+ * A thread holding an exclusive catalog or players lock is alone below it, and skips the locks below it.
+ * Locks taken by a system that is not thread safe(NULL ChessLocks) do nothing.
+ */
+#define LOCKS_PLAYER_STRIPES 64
+
+/* ----------------------------------------------------------------------
+
+                         Data structs declerations
+
+------------------------------------------------------------------------*/
+/** The locks of a thread safe chess system(but the tournaments' own locks) */
+typedef struct chess_locks_t *ChessLocks;
+
+/* ----------------------------------------------------------------------
+
+                         Header functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Creates the locks of a thread safe chess system
+ *
+ * @return ChessLocks(NULL if an allocation failed)
+ */
+ChessLocks locksCreate(void);
+
+/**
+ * @brief Frees a system's locks(none may be held)
+ *
+ * @param locks
+ */
+void locksDestroy(ChessLocks locks);
+
+/**
+ * @brief Locks the tournaments catalog
+ *
+ * @param locks
+ * @param exclusive - whether the caller changes the catalog or walks the whole system
+ */
+void locksLockCatalog(ChessLocks locks, bool exclusive);
+
+/**
+ * @brief Unlocks the tournaments catalog
+ *
+ * @param locks
+ */
+void locksUnlockCatalog(ChessLocks locks);
+
+/**
+ * @brief Locks a single tournament(the catalog must be held)
+ *
+ * @param locks
+ * @param tournament
+ */
+void locksLockTournament(ChessLocks locks, ChessTournament tournament);
+
+/**
+ * @brief Unlocks a single tournament
+ *
+ * @param locks
+ * @param tournament
+ */
+void locksUnlockTournament(ChessLocks locks, ChessTournament tournament);
+
+/**
+ * @brief Locks the structure of the players maps
+ *
+ * @param locks
+ * @param exclusive - whether the caller adds players
+ */
+void locksLockPlayers(ChessLocks locks, bool exclusive);
+
+/**
+ * @brief Unlocks the structure of the players maps
+ *
+ * @param locks
+ */
+void locksUnlockPlayers(ChessLocks locks);
+
+/**
+ * @brief Locks the stripes of two players(a stripe shared by both is locked once)
+ *
+ * @param locks
+ * @param first_player
+ * @param second_player - may equal first_player
+ */
+void locksLockStripes(ChessLocks locks, int first_player, int second_player);
+
+/**
+ * @brief Unlocks the stripes of two players
+ *
+ * @param locks
+ * @param first_player
+ * @param second_player
+ */
+void locksUnlockStripes(ChessLocks locks, int first_player, int second_player);
+
+/**
+ * @brief Locks the players levels order
+ *
+ * @param locks
+ */
+void locksLockLevels(ChessLocks locks);
+
+/**
+ * @brief Unlocks the players levels order
+ *
+ * @param locks
+ */
+void locksUnlockLevels(ChessLocks locks);
+
+/**
+ * @brief Locks the system's log
+ *
+ * @param locks
+ */
+void locksLockLog(ChessLocks locks);
+
+/**
+ * @brief Unlocks the system's log
+ *
+ * @param locks
+ */
+void locksUnlockLog(ChessLocks locks);
+
+#endif
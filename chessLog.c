@@ -0,0 +1,389 @@
+#define _POSIX_C_SOURCE 200809L
+#include "./chessLog.h"
+#include "./chessSnapshot.h"
+#include "./chessReturnsMacros.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+/* ----------------------------------------------------------------------
+
+                         Log required constants
+
+------------------------------------------------------------------------*/
+#define LOG_MAGIC "CHWL"
+#define LOG_MAGIC_SIZE 4
+#define LOG_HEADER_SIZE (LOG_MAGIC_SIZE + SNAPSHOT_INT_SIZE)
+#define LOG_BODY_FIXED_INTS 4
+#define LOG_RECORD_FRAME_SIZE (2 * SNAPSHOT_INT_SIZE)
+#define LOG_MIN_CAPACITY 4096
+#define LOG_WRITE_THRESHOLD 65536
+/* ----------------------------------------------------------------------
+
+                         Data structs defenitions
+
+------------------------------------------------------------------------*/
+/** Struct used for pointing at a log's details
+ * @param file - the log file(opened for appending)
+ * @param policy - when appended records are synced
+ * @param batch_size - amount of records per sync with CHESS_LOG_SYNC_BATCH
+ * @param pending - amount of records appended since the last sync
+ * @param failed - whether appending or writing a record failed since the log was opened
+ * @param buffer - encoded records waiting to be written to the file
+ * @param used - amount of bytes waiting in the buffer
+ * @param capacity - the buffer's allocated size
+ */
+struct chess_log_t
+{
+    FILE *file;
+    ChessLogSyncPolicy policy;
+    int batch_size;
+    int pending;
+    bool failed;
+    unsigned char *buffer;
+    int used;
+    int capacity;
+};
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Makes sure a log's buffer has room for a given amount of bytes(growing it when needed)
+ *
+ * @param log
+ * @param amount
+ * @return true
+ * @return false - if the allocation failed
+ */
+static bool logReserve(ChessLog log, int amount);
+
+/**
+ * @brief Encodes an int into a log's buffer(logReserve must have made room for it)
+ *
+ * @param log
+ * @param value
+ */
+static void logPutInt(ChessLog log, int value);
+
+/**
+ * @brief Writes the buffer's bytes to the log file(without waiting for the disk) and empties the buffer
+ *
+ * @param log
+ */
+static void logWrite(ChessLog log);
+
+/**
+ * @brief Reads a log file's records one after the other and applies them, stopping at the first torn record
+ *
+ * @param file
+ * @param file_size
+ * @param after_sequence
+ * @param apply
+ * @param context
+ * @param valid_end - filled with the offset right after the last whole record
+ * @return ChessResult(as logReplay)
+ */
+static ChessResult logReplayRecords(FILE *file, long file_size, int after_sequence, LogApplyFunction apply,
+                                    void *context, long *valid_end);
+
+/**
+ * @brief Decodes a record's body and applies it, unless its sequence was already applied
+ *
+ * @param body
+ * @param body_size
+ * @param expected_sequence - the sequence the next applied record must have(advanced when a record is applied)
+ * @param apply
+ * @param context
+ * @return ChessResult(as logReplay)
+ */
+static ChessResult logApplyBody(const unsigned char *body, int body_size, int *expected_sequence,
+                                LogApplyFunction apply, void *context);
+
+/* ----------------------------------------------------------------------
+
+                 Header included functions defenitions
+
+------------------------------------------------------------------------*/
+ChessLog logOpen(const char* path_file, ChessLogSyncPolicy policy, int batch_size)
+{
+    CHECK_NULL_RETURN(path_file);
+    ChessLog new_log = malloc(sizeof(struct chess_log_t));
+    CHECK_NULL_RETURN(new_log);
+    new_log->file = fopen(path_file, "ab");
+    if (new_log->file == NULL)
+    {
+        free(new_log);
+        return NULL;
+    }
+    new_log->policy = policy;
+    new_log->batch_size = (batch_size > 0) ? batch_size : 1;
+    new_log->pending = 0;
+    new_log->failed = false;
+    new_log->buffer = NULL;
+    new_log->used = 0;
+    new_log->capacity = 0;
+
+    long size = (fseek(new_log->file, 0, SEEK_END) == 0) ? ftell(new_log->file) : -1;
+    if (size == 0)
+    {
+        if (logReserve(new_log, LOG_HEADER_SIZE))
+        {
+            memcpy(new_log->buffer, LOG_MAGIC, LOG_MAGIC_SIZE);
+            new_log->used = LOG_MAGIC_SIZE;
+            logPutInt(new_log, LOG_VERSION);
+        }
+        else
+        {
+            new_log->failed = true;
+        }
+    }
+    if (size < 0 || logSync(new_log) != CHESS_SUCCESS)
+    {
+        logClose(new_log);
+        return NULL;
+    }
+    return new_log;
+}
+
+ChessResult logAppend(ChessLog log, const LogRecord* record)
+{
+    CHESS_CHECK_NULL_RETURN(log);
+    CHESS_CHECK_NULL_RETURN(record);
+    int text_length = (record->text == NULL) ? 0 : strlen(record->text);
+    int body_size = (LOG_BODY_FIXED_INTS + record->values_amount) * SNAPSHOT_INT_SIZE + text_length;
+    if (!logReserve(log, body_size + LOG_RECORD_FRAME_SIZE))
+    {
+        log->failed = true;
+        return CHESS_SAVE_FAILURE;
+    }
+
+    logPutInt(log, body_size);
+    unsigned char *body = log->buffer + log->used;
+    logPutInt(log, record->sequence);
+    logPutInt(log, record->operation);
+    logPutInt(log, record->values_amount);
+    for (int i = 0; i < record->values_amount; i++)
+    {
+        logPutInt(log, record->values[i]);
+    }
+    logPutInt(log, text_length);
+    if (text_length > 0)
+    {
+        memcpy(log->buffer + log->used, record->text, text_length);
+        log->used += text_length;
+    }
+    snapshotEncodeUnsigned(snapshotChecksum(body, body_size), log->buffer + log->used);
+    log->used += SNAPSHOT_INT_SIZE;
+    log->pending++;
+
+    if (log->used >= LOG_WRITE_THRESHOLD)
+    {
+        logWrite(log);
+    }
+    return log->failed ? CHESS_SAVE_FAILURE : CHESS_SUCCESS;
+}
+
+ChessResult logCommit(ChessLog log)
+{
+    CHESS_CHECK_NULL_RETURN(log);
+    if (log->pending > 0 && (log->policy == CHESS_LOG_SYNC_EVERY_COMMIT ||
+                             (log->policy == CHESS_LOG_SYNC_BATCH && log->pending >= log->batch_size)))
+    {
+        return logSync(log);
+    }
+    return log->failed ? CHESS_SAVE_FAILURE : CHESS_SUCCESS;
+}
+
+ChessResult logSync(ChessLog log)
+{
+    CHESS_CHECK_NULL_RETURN(log);
+    logWrite(log);
+    if (fflush(log->file) != 0 || fsync(fileno(log->file)) != 0)
+    {
+        log->failed = true;
+    }
+    log->pending = 0;
+    return log->failed ? CHESS_SAVE_FAILURE : CHESS_SUCCESS;
+}
+
+ChessResult logClose(ChessLog log)
+{
+    CHESS_CHECK_NULL_RETURN(log);
+    ChessResult result = logSync(log);
+    if (fclose(log->file) != 0)
+    {
+        result = CHESS_SAVE_FAILURE;
+    }
+    free(log->buffer);
+    free(log);
+    return result;
+}
+
+ChessResult logReplay(const char* path_file, int after_sequence, LogApplyFunction apply, void* context)
+{
+    CHESS_CHECK_NULL_RETURN(path_file);
+    CHESS_CHECK_NULL_RETURN(apply);
+    FILE *file = fopen(path_file, "rb");
+    if (file == NULL)
+    {
+        return CHESS_SUCCESS;
+    }
+    long file_size = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : -1;
+    if (file_size < 0 || fseek(file, 0, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return CHESS_SAVE_FAILURE;
+    }
+
+    long valid_end = 0;
+    ChessResult result = logReplayRecords(file, file_size, after_sequence, apply, context, &valid_end);
+    fclose(file);
+    if (result == CHESS_SUCCESS && valid_end < file_size && truncate(path_file, valid_end) != 0)
+    {
+        result = CHESS_SAVE_FAILURE;
+    }
+    return result;
+}
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions defenitions
+
+------------------------------------------------------------------------*/
+static bool logReserve(ChessLog log, int amount)
+{
+    if (log->capacity - log->used >= amount)
+    {
+        return true;
+    }
+    int new_capacity = (log->capacity > 0) ? log->capacity : LOG_MIN_CAPACITY;
+    while (new_capacity - log->used < amount)
+    {
+        new_capacity *= 2;
+    }
+    unsigned char *new_buffer = realloc(log->buffer, new_capacity);
+    if (new_buffer == NULL)
+    {
+        return false;
+    }
+    log->buffer = new_buffer;
+    log->capacity = new_capacity;
+    return true;
+}
+
+static void logPutInt(ChessLog log, int value)
+{
+    snapshotEncodeInt(value, log->buffer + log->used);
+    log->used += SNAPSHOT_INT_SIZE;
+}
+
+static void logWrite(ChessLog log)
+{
+    if (log->used > 0 && fwrite(log->buffer, 1, log->used, log->file) != (size_t)log->used)
+    {
+        log->failed = true;
+    }
+    log->used = 0;
+}
+
+static ChessResult logReplayRecords(FILE *file, long file_size, int after_sequence, LogApplyFunction apply,
+                                    void *context, long *valid_end)
+{
+    *valid_end = 0;
+    if (file_size < LOG_HEADER_SIZE)
+    {
+        return CHESS_SUCCESS;
+    }
+    unsigned char header[LOG_HEADER_SIZE];
+    if (fread(header, 1, LOG_HEADER_SIZE, file) != LOG_HEADER_SIZE ||
+        memcmp(header, LOG_MAGIC, LOG_MAGIC_SIZE) != 0 || snapshotDecodeInt(header + LOG_MAGIC_SIZE) != LOG_VERSION)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    *valid_end = LOG_HEADER_SIZE;
+
+    int expected_sequence = after_sequence + 1;
+    unsigned char size_bytes[SNAPSHOT_INT_SIZE];
+    while (fread(size_bytes, 1, SNAPSHOT_INT_SIZE, file) == SNAPSHOT_INT_SIZE)
+    {
+        int body_size = snapshotDecodeInt(size_bytes);
+        if (body_size < LOG_BODY_FIXED_INTS * SNAPSHOT_INT_SIZE ||
+            body_size > file_size - *valid_end - LOG_RECORD_FRAME_SIZE)
+        {
+            return CHESS_SUCCESS;
+        }
+        unsigned char *body = malloc(body_size + SNAPSHOT_INT_SIZE);
+        if (body == NULL)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        if (fread(body, 1, body_size + SNAPSHOT_INT_SIZE, file) != (size_t)(body_size + SNAPSHOT_INT_SIZE) ||
+            snapshotChecksum(body, body_size) != snapshotDecodeUnsigned(body + body_size))
+        {
+            free(body);
+            return CHESS_SUCCESS;
+        }
+        ChessResult result = logApplyBody(body, body_size, &expected_sequence, apply, context);
+        free(body);
+        CHESS_CHECK_NOT_SUCCESS_RETURN(result);
+        *valid_end += body_size + LOG_RECORD_FRAME_SIZE;
+    }
+    return CHESS_SUCCESS;
+}
+
+static ChessResult logApplyBody(const unsigned char *body, int body_size, int *expected_sequence,
+                                LogApplyFunction apply, void *context)
+{
+    LogRecord record;
+    record.sequence = snapshotDecodeInt(body);
+    record.operation = (LogOperation)snapshotDecodeInt(body + SNAPSHOT_INT_SIZE);
+    record.values_amount = snapshotDecodeInt(body + 2 * SNAPSHOT_INT_SIZE);
+    if (record.values_amount < 0 || record.values_amount > LOG_MAX_VALUES ||
+        body_size < (LOG_BODY_FIXED_INTS + record.values_amount) * SNAPSHOT_INT_SIZE)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    const unsigned char *current = body + 3 * SNAPSHOT_INT_SIZE;
+    for (int i = 0; i < record.values_amount; i++)
+    {
+        record.values[i] = snapshotDecodeInt(current);
+        current += SNAPSHOT_INT_SIZE;
+    }
+    int text_length = snapshotDecodeInt(current);
+    current += SNAPSHOT_INT_SIZE;
+    if (text_length != body_size - (current - body))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+
+    if (record.sequence < *expected_sequence)
+    {
+        return CHESS_SUCCESS;
+    }
+    if (record.sequence > *expected_sequence)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    char *text = NULL;
+    if (text_length > 0)
+    {
+        text = malloc(text_length + 1);
+        if (text == NULL)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        memcpy(text, current, text_length);
+        text[text_length] = '\0';
+    }
+    record.text = text;
+    ChessResult result = apply(context, &record);
+    free(text);
+    if (result == CHESS_SUCCESS)
+    {
+        (*expected_sequence)++;
+    }
+    return result;
+}
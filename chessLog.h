@@ -0,0 +1,144 @@
+#ifndef _CHESS_LOG_H
+#define _CHESS_LOG_H
+#include <stdbool.h>
+#include "./chessSystem.h"
+
+/* ----------------------------------------------------------------------
+
+                         Log file format
+
+------------------------------------------------------------------------*/
+/*
+ * A log file is:
+ *   magic        - the 4 bytes "CHWL"
+ *   version      - int(LOG_VERSION)
+ *   records      - one after the other, in the order they were appended
+ * A record is:
+ *   size         - int, the size in bytes of the record's body
+ *   body         - sequence(int), operation(int), amount of values(int), the values(ints), text(string)
+ *   checksum     - CRC-32 of the body, as an unsigned int
+ * Ints and strings are encoded as in snapshots(see chessSnapshot.h). A record that was cut short or
+ * whose checksum is wrong marks the end of the log(it is the tail of a write a crash interrupted).
+ */
+#define LOG_VERSION 1
+#define LOG_MAX_VALUES 5
+
+/* ----------------------------------------------------------------------
+
+                         Data structs declerations
+
+------------------------------------------------------------------------*/
+/** An append-only log of the operations applied to a chess system, written in batches */
+typedef struct chess_log_t *ChessLog;
+
+/** The chess system operations a log records */
+typedef enum
+{
+    LOG_ADD_TOURNAMENT = 1,
+    LOG_ADD_GAME,
+    LOG_REMOVE_PLAYER,
+    LOG_REMOVE_TOURNAMENT,
+    LOG_END_TOURNAMENT
+} LogOperation;
+
+/** A single operation in a log
+ * @param sequence - the operation's number in the system(the first operation ever applied is 1)
+ * @param operation - which operation was applied
+ * @param values - the operation's int arguments
+ * @param values_amount - amount of values used(at most LOG_MAX_VALUES)
+ * @param text - the operation's string argument(NULL if it has none)
+ */
+typedef struct log_record_t
+{
+    int sequence;
+    LogOperation operation;
+    int values[LOG_MAX_VALUES];
+    int values_amount;
+    const char *text;
+} LogRecord;
+
+/** Applies a record read back from a log(used by logReplay) */
+typedef ChessResult (*LogApplyFunction)(void *context, const LogRecord *record);
+
+/* ----------------------------------------------------------------------
+
+                         Header functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Opens a log file for appending(creating it, with its header, if it does not exist)
+ *
+ * @param path_file
+ * @param policy - when appended records are made durable(see ChessLogSyncPolicy)
+ * @param batch_size - amount of records per sync with CHESS_LOG_SYNC_BATCH
+ * @return ChessLog(NULL if the file could not be opened or an allocation failed)
+ */
+ChessLog logOpen(const char* path_file, ChessLogSyncPolicy policy, int batch_size);
+
+/**
+ * @brief Appends a record to a log's current commit. The record is buffered(written to the file once enough
+ * records pile up), and made durable by the logCommit ending its commit or by logSync. A failure is kept
+ * and reported by every later append, commit and sync
+ *
+ * @param log
+ * @param record
+ * @return
+ * CHESS_NULL_ARGUMENT
+ * CHESS_SAVE_FAILURE - if appending or writing a record(this one included) failed at any point since the log
+ * was opened
+ * CHESS_SUCCESS
+ */
+ChessResult logAppend(ChessLog log, const LogRecord* record);
+
+/**
+ * @brief Ends a log's current commit(the records appended since the previous one), syncing the log when its
+ * policy says so: every commit with CHESS_LOG_SYNC_EVERY_COMMIT, and once batch_size records were appended
+ * with CHESS_LOG_SYNC_BATCH
+ *
+ * @param log
+ * @return
+ * CHESS_NULL_ARGUMENT
+ * CHESS_SAVE_FAILURE - if appending or writing a record failed at any point since the log was opened(with
+ * CHESS_LOG_SYNC_EVERY_COMMIT, the commit is not known to be on disk)
+ * CHESS_SUCCESS
+ */
+ChessResult logCommit(ChessLog log);
+
+/**
+ * @brief Writes every record appended so far to the log file and waits until it is on disk
+ *
+ * @param log
+ * @return
+ * CHESS_SAVE_FAILURE - if writing a record failed at any point since the log was opened
+ * CHESS_SUCCESS
+ */
+ChessResult logSync(ChessLog log);
+
+/**
+ * @brief Syncs a log, closes its file and frees it
+ *
+ * @param log
+ * @return
+ * CHESS_SAVE_FAILURE - if writing a record failed at any point since the log was opened
+ * CHESS_SUCCESS
+ */
+ChessResult logClose(ChessLog log);
+
+/**
+ * @brief Applies, in order, the records of a log file whose sequence is after a given one.
+ * A torn record at the end of the file is cut off the file, so records appended later follow the last whole one
+ *
+ * @param path_file
+ * @param after_sequence - records up to this sequence(included) are skipped
+ * @param apply
+ * @param context - passed to apply
+ * @return
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SAVE_FAILURE - if the file is not a log, a record is invalid, a record is missing
+ * between after_sequence and the next one, or the file could not be cut
+ * The result of apply - if it failed
+ * CHESS_SUCCESS - also if the file does not exist(nothing was logged)
+ */
+ChessResult logReplay(const char* path_file, int after_sequence, LogApplyFunction apply, void* context);
+
+#endif
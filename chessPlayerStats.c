@@ -2,8 +2,10 @@
 
 #include "./chessPlayerStats.h"
 #include "./chessReturnsMacros.h"
+#include "./chessWriter.h"
 #include <stdbool.h>
 #include <stdlib.h>
+#include <math.h>
 /* ----------------------------------------------------------------------
 
                          Player stats required constants
@@ -28,6 +30,10 @@
     double level;
 } ;
 
+/** Struct used for holding a player's preformance(in a tournament or in the whole system)
+ * @param player_id - id of the player the stats belong to(STATS_NOT_CALCULATED if created by createPlayerStats)
+ * @param standing - node linking the stats into a tournament's standings, or the system's stats into the system's levels
+ */
  struct player_stats_t
 {
     int time_played;
@@ -35,6 +41,8 @@
     int losses;
     int draws;
     int score;
+    int player_id;
+    MapNode standing;
 } ;
 
 /* ----------------------------------------------------------------------
@@ -108,6 +116,48 @@ static Winner statsFlipWinner(Winner winner);
  */
 static void sortPlayersLevelsList(PlayerRank level_list,int size);
 
+/**
+ * @brief Compares two player's ranks by their printing order[used as qsort's compare function]
+ * higher level first, then lower id. Ranks with no level(players without games) are printed last
+ * 
+ * @param first_rank 
+ * @param second_rank 
+ * @return Negative if the first rank is printed first, positive if the second one is
+ */
+static int comparePlayersRanks(const void* first_rank,const void* second_rank);
+
+/**
+ * @brief Moves the k top ranks of a list to its first k cells(in no particular order)[partial selection through
+ * a heap of the top ranks found so far, with the lowest of them at its root]
+ * 
+ * @param level_list 
+ * @param size - length of the list
+ * @param k - amount of ranks to select(at most size)
+ */
+static void selectTopPlayersLevels(PlayerRank level_list,int size,int k);
+
+/**
+ * @brief Restores the heap order of selectTopPlayersLevels below a given cell of the heap
+ * 
+ * @param heap 
+ * @param size - amount of cells in the heap
+ * @param position 
+ */
+static void siftDownPlayersLevels(PlayerRank heap,int size,int position);
+
+/**
+ * @brief Prints the first cells of a sorted player ranks list into a given file(through a ChessWriter)
+ * 
+ * @param list 
+ * @param size 
+ * @param file 
+ * @return 
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SAVE_FAILURE
+ * CHESS_SUCCESS
+ */
+static ChessResult printLevelList(PlayerRank list,int size, FILE* file);
+
 /**
  * @brief 
  * 
@@ -124,16 +174,25 @@ static bool checkValidStats(PlayerStats stats);
                  Header included functions defenitions
 
 ------------------------------------------------------------------------*/
-void insertLevelListToFile(PlayerRank list,int size, FILE* file)
+ChessResult insertLevelListToFile(PlayerRank list,int size, FILE* file)
 {
-    
-    PlayerRank current_player = list;
     sortPlayersLevelsList(list,size);
-    for(int i = 0; i < size; i++)
+    return printLevelList(list,size,file);
+}
+
+ChessResult insertTopLevelListToFile(PlayerRank list,int size,int k, FILE* file)
+{
+    if(k > size)
     {
-        fprintf(file ,  "%d %.2f\n",current_player->id, current_player->level);
-        current_player ++;
+        k = size;
     }
+    if(k <= 0)
+    {
+        return CHESS_SUCCESS;
+    }
+    selectTopPlayersLevels(list,size,k);
+    sortPlayersLevelsList(list,k);
+    return printLevelList(list,k,file);
 }
 
 PlayerRank statsGetNextPlayerRankList(PlayerRank list)
@@ -184,9 +243,21 @@ PlayerStats createBlankPlayerStats()
     new_tournament_stats->losses = losses;
     new_tournament_stats->draws = draws;
     new_tournament_stats->score = STATS_NOT_CALCULATED;
+    new_tournament_stats->player_id = STATS_NOT_CALCULATED;
     return new_tournament_stats;
 }
 
+ PlayerStats initPlayerStats(void* player_id)
+{
+    PlayerStats new_stats = createPlayerStats(0, 0, 0);
+    zeroPlayerStats(new_stats);
+    if(new_stats != NULL && player_id != NULL)
+    {
+        new_stats->player_id = *(int*)player_id;
+    }
+    return new_stats;
+}
+
  PlayerStats copyPlayerStats(PlayerStats original_stats)
 {
     PlayerStats new_tournament_stats = malloc(sizeof(struct player_stats_t));
@@ -195,6 +266,7 @@ PlayerStats createBlankPlayerStats()
     new_tournament_stats->losses = original_stats->losses;
     new_tournament_stats->draws = original_stats->draws;
     new_tournament_stats->score = original_stats->score;
+    new_tournament_stats->player_id = original_stats->player_id;
     return new_tournament_stats;
 }
 
@@ -330,6 +402,14 @@ double calculateLevel(PlayerStats chess_stats)
     stats_summary->time_played -= stats_update->time_played;
 }
 
+void statsAddResults(PlayerStats stats, int wins, int losses, int draws, int time_played)
+{
+    stats->wins += wins;
+    stats->losses += losses;
+    stats->draws += draws;
+    stats->time_played += time_played;
+}
+
 void statsAddStats(PlayerStats stats_summary, PlayerStats stats_update)
 {
     
@@ -349,6 +429,91 @@ Winner statsTournamentCompareHigher(PlayerStats first_stats,PlayerStats second_s
     return statsCompareWins(first_stats,second_stats);
     
 }
+
+int statsGetPlayerId(PlayerStats stats)
+{
+    if(stats == NULL)
+        return STATS_NOT_CALCULATED;
+    return stats->player_id;
+}
+
+MapNode* statsGetStandingNode(PlayerStats stats)
+{
+    if(stats == NULL)
+        return NULL;
+    return &stats->standing;
+}
+
+PlayerStats statsFromStandingNode(const MapNode* node)
+{
+    if(node == NULL)
+        return NULL;
+    return MAP_NODE_ENTRY(node, struct player_stats_t, standing);
+}
+
+MapKeyElement statsGetStandingKey(const MapNode* node)
+{
+    return (MapKeyElement)statsFromStandingNode(node);
+}
+
+void statsSaveSnapshot(PlayerStats stats, SnapshotWriter writer)
+{
+    snapshotPutInt(writer,stats->time_played);
+    snapshotPutInt(writer,stats->wins);
+    snapshotPutInt(writer,stats->losses);
+    snapshotPutInt(writer,stats->draws);
+    snapshotPutInt(writer,stats->score);
+}
+
+void statsLoadSnapshot(PlayerStats stats, SnapshotReader reader)
+{
+    stats->time_played = snapshotGetInt(reader);
+    stats->wins = snapshotGetInt(reader);
+    stats->losses = snapshotGetInt(reader);
+    stats->draws = snapshotGetInt(reader);
+    stats->score = snapshotGetInt(reader);
+}
+
+int statsCompareLevels(MapKeyElement first_stats, MapKeyElement second_stats)
+{
+    PlayerStats first = first_stats;
+    PlayerStats second = second_stats;
+    struct player_rank_t first_rank = {first->player_id, calculateLevel(first)};
+    struct player_rank_t second_rank = {second->player_id, calculateLevel(second)};
+    return comparePlayersRanks(&first_rank,&second_rank);
+}
+
+void statsLinkStanding(IntrusiveMap* standings, PlayerStats stats)
+{
+    if(standings != NULL && stats != NULL)
+    {
+        intrusiveMapInsert(standings,&stats->standing);
+    }
+}
+
+void statsUnlinkStanding(IntrusiveMap* standings, PlayerStats stats)
+{
+    if(standings != NULL && stats != NULL)
+    {
+        intrusiveMapRemove(standings,&stats->standing);
+    }
+}
+
+int statsCompareStandings(MapKeyElement first_stats, MapKeyElement second_stats)
+{
+    PlayerStats first = first_stats;
+    PlayerStats second = second_stats;
+    Winner higher = statsTournamentCompareHigher(first,second);
+    if(higher == FIRST_PLAYER)
+    {
+        return -1;
+    }
+    if(higher == SECOND_PLAYER)
+    {
+        return 1;
+    }
+    return first->player_id - second->player_id;
+}
 /* ----------------------------------------------------------------------
 
                 Non header included functions defenitions
@@ -356,23 +521,82 @@ Winner statsTournamentCompareHigher(PlayerStats first_stats,PlayerStats second_s
 ------------------------------------------------------------------------*/
 static void sortPlayersLevelsList(PlayerRank level_list,int size)
 {
-    for(int i = 0; i< size-1;i++)
-        for(int j = 0; j < size - i -1;j++)
+    if(size > 1)
+    {
+        qsort(level_list,size,sizeof(struct player_rank_t),comparePlayersRanks);
+    }
+}
+
+static int comparePlayersRanks(const void* first_rank,const void* second_rank)
+{
+    const struct player_rank_t* first = first_rank;
+    const struct player_rank_t* second = second_rank;
+    bool first_has_level = !isnan(first->level);
+    bool second_has_level = !isnan(second->level);
+    if(first_has_level != second_has_level)
+    {
+        return first_has_level ? -1 : 1;
+    }
+    if(first_has_level && first->level != second->level)
+    {
+        return (first->level > second->level) ? -1 : 1;
+    }
+    return (first->id > second->id) - (first->id < second->id);
+}
+
+static void selectTopPlayersLevels(PlayerRank level_list,int size,int k)
+{
+    for(int i = k/2 - 1; i >= 0; i--)
+    {
+        siftDownPlayersLevels(level_list,k,i);
+    }
+    for(int i = k; i < size; i++)
+    {
+        if(comparePlayersRanks(&level_list[i],&level_list[0]) < 0)
         {
-            PlayerRank current = &level_list[j];
-            PlayerRank next = &level_list[j+1];
-            if(current->level < next->level 
-            || ((current->level == next->level)&& current->level > next->level))
-            {
-                double swap_level = current->level;
-                int swap_id = current->id;
-                current->level = next->level;
-                current->id = next->id;
-                next->level = swap_level;
-                next->id = swap_id;
-            }
-                 
+            struct player_rank_t swap = level_list[0];
+            level_list[0] = level_list[i];
+            level_list[i] = swap;
+            siftDownPlayersLevels(level_list,k,0);
+        }
+    }
+}
+
+static void siftDownPlayersLevels(PlayerRank heap,int size,int position)
+{
+    while(2*position + 1 < size)
+    {
+        int lowest = 2*position + 1;
+        if(lowest + 1 < size && comparePlayersRanks(&heap[lowest + 1],&heap[lowest]) > 0)
+        {
+            lowest++;
         }
+        if(comparePlayersRanks(&heap[lowest],&heap[position]) <= 0)
+        {
+            return;
+        }
+        struct player_rank_t swap = heap[position];
+        heap[position] = heap[lowest];
+        heap[lowest] = swap;
+        position = lowest;
+    }
+}
+
+static ChessResult printLevelList(PlayerRank list,int size, FILE* file)
+{
+    ChessWriter writer = writerCreate(file);
+    if(writer == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    for(int i = 0; i < size; i++)
+    {
+        writerPutInt(writer,list[i].id);
+        writerPutChar(writer,' ');
+        writerPutFixed2(writer,list[i].level);
+        writerPutChar(writer,'\n');
+    }
+    return writerDestroy(writer);
 }
 
 static bool checkValidStats(PlayerStats stats)
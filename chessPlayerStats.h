@@ -4,6 +4,8 @@
 #include<stdio.h>
 #include<stdbool.h>
 #include"./chessSystem.h"
+#include"./mtm_map/map.h"
+#include"./chessSnapshot.h"
 /* ----------------------------------------------------------------------
 
                          Player stats required constants
@@ -33,8 +35,25 @@ typedef struct player_rank_t *PlayerRank;
  * @param list 
  * @param size 
  * @param file 
+ * @return 
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SAVE_FAILURE - if writing to the file failed
+ * CHESS_SUCCESS
  */
-void insertLevelListToFile(PlayerRank list,int size, FILE* file);
+ChessResult insertLevelListToFile(PlayerRank list,int size, FILE* file);
+/**
+ * @brief Prints the k top player ranks of a list into a given file(in O(size*log(k)), the list's order is changed)
+ * 
+ * @param list 
+ * @param size 
+ * @param k - amount of ranks to print(all of them if k is larger than size, none if k is not positive)
+ * @param file 
+ * @return 
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SAVE_FAILURE - if writing to the file failed
+ * CHESS_SUCCESS
+ */
+ChessResult insertTopLevelListToFile(PlayerRank list,int size,int k, FILE* file);
 /**
  * @brief Calulates a player level(system criteria) by given stats
  * 
@@ -96,6 +115,14 @@ PlayerStats createBlankPlayerStats();
  */
  PlayerStats createPlayerStats(int wins, int losses, int draws);
 
+ /**
+  * @brief Creates zeroed stats for a player newly added to a stats map[used as the map's init function of mapGetOrInsert]
+  * 
+  * @param player_id key of the new player(an int*), stored in the stats as their player's id
+  * @return PlayerStats struct with zero values and the given player id(NULL if allocation failed)
+  */
+ PlayerStats initPlayerStats(void* player_id);
+
  /**
   * @brief Makes a copy of given PlayerStats type[used primarilly in map GDT as copy function]
   * 
@@ -229,6 +256,90 @@ int statsGetTotalGames(PlayerStats stats);
  */
 Winner statsTournamentCompareHigher(PlayerStats first_stats,PlayerStats second_stats);
 
+/**
+ * @brief Returns the id of the player given stats belong to[set by initPlayerStats]
+ * 
+ * @param stats 
+ * @return The player's id(STATS_NOT_CALCULATED if unknown)
+ */
+int statsGetPlayerId(PlayerStats stats);
+
+/**
+ * @brief Returns the node linking given stats into a tournament's standings(an IntrusiveMap)
+ * 
+ * @param stats 
+ * @return MapNode* 
+ */
+MapNode* statsGetStandingNode(PlayerStats stats);
+
+/**
+ * @brief Returns the stats a standings node is embedded in
+ * 
+ * @param node 
+ * @return PlayerStats 
+ */
+PlayerStats statsFromStandingNode(const MapNode* node);
+
+/**
+ * @brief Returns the key of a standings node(the stats it is embedded in)[used as the standings' getKey function]
+ * 
+ * @param node 
+ * @return MapKeyElement 
+ */
+MapKeyElement statsGetStandingKey(const MapNode* node);
+
+/**
+ * @brief Compares two player's stats by their tournament standing[used as the standings' compare function]
+ * higher points first, then fewer losses, then more wins, then lower player id
+ * 
+ * @param first_stats 
+ * @param second_stats 
+ * @return Negative if the first stats rank higher, positive if the second ones do(zero only for the same player)
+ */
+int statsCompareStandings(MapKeyElement first_stats, MapKeyElement second_stats);
+
+/**
+ * @brief Compares two player's stats by their system level[used as the compare function of the system's levels]
+ * in the order of the players levels file: higher level first, then lower player id, players without games last
+ * 
+ * @param first_stats 
+ * @param second_stats 
+ * @return Negative if the first stats rank higher, positive if the second ones do(zero only for the same player)
+ */
+int statsCompareLevels(MapKeyElement first_stats, MapKeyElement second_stats);
+
+/**
+ * @brief Links given stats into an ordered structure of stats(a tournament's standings or the system's levels)
+ * 
+ * @param standings 
+ * @param stats 
+ */
+void statsLinkStanding(IntrusiveMap* standings, PlayerStats stats);
+
+/**
+ * @brief Unlinks given stats from the ordered structure they are in[must be called before the stats change]
+ * 
+ * @param standings 
+ * @param stats 
+ */
+void statsUnlinkStanding(IntrusiveMap* standings, PlayerStats stats);
+
+/**
+ * @brief Writes given stats' values(not the player id or the standing) to a snapshot
+ * 
+ * @param stats 
+ * @param writer 
+ */
+void statsSaveSnapshot(PlayerStats stats, SnapshotWriter writer);
+
+/**
+ * @brief Reads into given stats the values written by statsSaveSnapshot[the stats must not be linked into standings]
+ * 
+ * @param stats 
+ * @param reader 
+ */
+void statsLoadSnapshot(PlayerStats stats, SnapshotReader reader);
+
 /**
  * @brief Substracts all of the stats given in the second argument from the first one
  * 
@@ -237,4 +348,15 @@ Winner statsTournamentCompareHigher(PlayerStats first_stats,PlayerStats second_s
  */
 void statsSubtractStats(PlayerStats stats_summary, PlayerStats stats_update);
 
+/**
+ * @brief Adds a number of game results and play time to given stats at once
+ * 
+ * @param stats 
+ * @param wins 
+ * @param losses 
+ * @param draws 
+ * @param time_played 
+ */
+void statsAddResults(PlayerStats stats, int wins, int losses, int draws, int time_played);
+
 #endif
\ No newline at end of file
@@ -30,8 +30,8 @@
      if (mapContains(chess->system_tournaments, &tournament_id))\
         return CHESS_TOURNAMENT_ALREADY_EXISTS;\
 
-#define CHESS_CHECK_TOURNAMENT_DOES_EXIST_RETURN(chess,id) \
-     if (!mapContains(chess->system_tournaments, &tournament_id))\
+#define CHESS_CHECK_TOURNAMENT_FOUND_RETURN(tournament) \
+     if (tournament == NULL)\
         return CHESS_TOURNAMENT_NOT_EXIST;\
 
 #define CHESS_CHECK_TOURNAMENT_NOT_ENDED_RETURN(tournament) \
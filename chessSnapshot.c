@@ -0,0 +1,315 @@
+#define _POSIX_C_SOURCE 200809L
+#include "./chessSnapshot.h"
+#include "./chessWriter.h"
+#include "./chessReturnsMacros.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+/* ----------------------------------------------------------------------
+
+                         Snapshot required constants
+
+------------------------------------------------------------------------*/
+#define SNAPSHOT_MAGIC "CHSS"
+#define SNAPSHOT_MAGIC_SIZE 4
+#define SNAPSHOT_HEADER_SIZE (SNAPSHOT_MAGIC_SIZE + SNAPSHOT_INT_SIZE)
+#define CRC_TABLE_SIZE 256
+#define CRC_POLYNOMIAL 0xEDB88320u
+#define CRC_INITIAL 0xFFFFFFFFu
+#define BITS_IN_BYTE 8
+#define BYTE_MASK 0xFFu
+/* ----------------------------------------------------------------------
+
+                         CRC-32 table(built once, by crcBuildTable)
+
+------------------------------------------------------------------------*/
+static uint32_t crc_table[CRC_TABLE_SIZE];
+static pthread_once_t crc_table_once = PTHREAD_ONCE_INIT;
+/* ----------------------------------------------------------------------
+
+                         Data structs defenitions
+
+------------------------------------------------------------------------*/
+/** Struct used for pointing at a snapshot writer's details
+ * @param writer - the buffered writer of the file
+ * @param checksum - running CRC-32 of the bytes written so far(not yet finalized)
+ */
+struct snapshot_writer_t
+{
+    ChessWriter writer;
+    uint32_t checksum;
+};
+
+/** Struct used for pointing at a snapshot reader's details
+ * @param data - the file's payload(between the header and the checksum)
+ * @param size - the payload's size in bytes
+ * @param position - offset of the next byte to read
+ * @param failed - whether a read went past the payload's end or found an invalid value
+ */
+struct snapshot_reader_t
+{
+    unsigned char *data;
+    long size;
+    long position;
+    bool failed;
+};
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Fills the CRC-32 table(run once, through crc_table_once)
+ */
+static void crcBuildTable(void);
+
+/**
+ * @brief Updates a running CRC-32 by given bytes(the table is built on the first call, safely across threads)
+ *
+ * @param checksum
+ * @param bytes
+ * @param amount
+ * @return The updated checksum
+ */
+static uint32_t crcUpdate(uint32_t checksum, const unsigned char *bytes, long amount);
+
+/**
+ * @brief Writes raw bytes to a snapshot, adding them to its checksum
+ *
+ * @param writer
+ * @param bytes
+ * @param amount
+ */
+static void snapshotPutBytes(SnapshotWriter writer, const void *bytes, int amount);
+
+/**
+ * @brief Reads a whole file into a newly allocated buffer
+ *
+ * @param file
+ * @param size - filled with the file's size
+ * @return The file's contents(NULL if reading failed)
+ */
+static unsigned char *snapshotReadFile(FILE *file, long *size);
+
+/* ----------------------------------------------------------------------
+
+                 Header included functions defenitions
+
+------------------------------------------------------------------------*/
+SnapshotWriter snapshotCreateWriter(FILE* file)
+{
+    CHECK_NULL_RETURN(file);
+    SnapshotWriter new_writer = malloc(sizeof(struct snapshot_writer_t));
+    CHECK_NULL_RETURN(new_writer);
+    new_writer->writer = writerCreate(file);
+    if (new_writer->writer == NULL)
+    {
+        free(new_writer);
+        return NULL;
+    }
+    new_writer->checksum = CRC_INITIAL;
+    snapshotPutBytes(new_writer, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+    snapshotPutInt(new_writer, SNAPSHOT_VERSION);
+    return new_writer;
+}
+
+void snapshotPutInt(SnapshotWriter writer, int value)
+{
+    unsigned char bytes[SNAPSHOT_INT_SIZE];
+    snapshotEncodeInt(value, bytes);
+    snapshotPutBytes(writer, bytes, SNAPSHOT_INT_SIZE);
+}
+
+void snapshotPutString(SnapshotWriter writer, const char* str)
+{
+    int length = strlen(str);
+    snapshotPutInt(writer, length);
+    snapshotPutBytes(writer, str, length);
+}
+
+ChessResult snapshotDestroyWriter(SnapshotWriter writer)
+{
+    CHESS_CHECK_NULL_RETURN(writer);
+    unsigned char bytes[SNAPSHOT_INT_SIZE];
+    snapshotEncodeUnsigned(writer->checksum ^ CRC_INITIAL, bytes);
+    writerPutBytes(writer->writer, bytes, SNAPSHOT_INT_SIZE);
+    ChessResult result = writerDestroy(writer->writer);
+    free(writer);
+    return result;
+}
+
+SnapshotReader snapshotCreateReader(FILE* file)
+{
+    CHECK_NULL_RETURN(file);
+    long size = 0;
+    unsigned char *data = snapshotReadFile(file, &size);
+    CHECK_NULL_RETURN(data);
+
+    long payload_end = size - SNAPSHOT_INT_SIZE;
+    if (payload_end < SNAPSHOT_HEADER_SIZE || memcmp(data, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) != 0 ||
+        snapshotDecodeInt(data + SNAPSHOT_MAGIC_SIZE) != SNAPSHOT_VERSION ||
+        snapshotChecksum(data, payload_end) != snapshotDecodeUnsigned(data + payload_end))
+    {
+        free(data);
+        return NULL;
+    }
+
+    SnapshotReader new_reader = malloc(sizeof(struct snapshot_reader_t));
+    if (new_reader == NULL)
+    {
+        free(data);
+        return NULL;
+    }
+    new_reader->data = data;
+    new_reader->size = payload_end;
+    new_reader->position = SNAPSHOT_HEADER_SIZE;
+    new_reader->failed = false;
+    return new_reader;
+}
+
+int snapshotGetInt(SnapshotReader reader)
+{
+    if (reader->failed || reader->size - reader->position < SNAPSHOT_INT_SIZE)
+    {
+        reader->failed = true;
+        return 0;
+    }
+    int value = snapshotDecodeInt(reader->data + reader->position);
+    reader->position += SNAPSHOT_INT_SIZE;
+    return value;
+}
+
+int snapshotGetCount(SnapshotReader reader, int item_size)
+{
+    int amount = snapshotGetInt(reader);
+    if (amount < 0 || (long)amount * item_size > reader->size - reader->position)
+    {
+        reader->failed = true;
+        return 0;
+    }
+    return amount;
+}
+
+char* snapshotGetString(SnapshotReader reader)
+{
+    int length = snapshotGetCount(reader, 1);
+    if (reader->failed)
+    {
+        return NULL;
+    }
+    char *str = malloc(length + 1);
+    if (str == NULL)
+    {
+        reader->failed = true;
+        return NULL;
+    }
+    memcpy(str, reader->data + reader->position, length);
+    str[length] = '\0';
+    reader->position += length;
+    return str;
+}
+
+bool snapshotReadComplete(SnapshotReader reader)
+{
+    return reader != NULL && !reader->failed && reader->position == reader->size;
+}
+
+void snapshotDestroyReader(SnapshotReader reader)
+{
+    if (reader != NULL)
+    {
+        free(reader->data);
+        free(reader);
+    }
+}
+
+void snapshotEncodeInt(int value, unsigned char* bytes)
+{
+    snapshotEncodeUnsigned((uint32_t)value, bytes);
+}
+
+int snapshotDecodeInt(const unsigned char* bytes)
+{
+    uint32_t value = snapshotDecodeUnsigned(bytes);
+    return (value > INT32_MAX) ? -(int)(UINT32_MAX - value) - 1 : (int)value;
+}
+
+void snapshotEncodeUnsigned(uint32_t value, unsigned char* bytes)
+{
+    for (int i = 0; i < SNAPSHOT_INT_SIZE; i++)
+    {
+        bytes[i] = (unsigned char)((value >> (BITS_IN_BYTE * i)) & BYTE_MASK);
+    }
+}
+
+uint32_t snapshotDecodeUnsigned(const unsigned char* bytes)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < SNAPSHOT_INT_SIZE; i++)
+    {
+        value |= (uint32_t)bytes[i] << (BITS_IN_BYTE * i);
+    }
+    return value;
+}
+
+uint32_t snapshotChecksum(const void* bytes, long amount)
+{
+    return crcUpdate(CRC_INITIAL, bytes, amount) ^ CRC_INITIAL;
+}
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions defenitions
+
+------------------------------------------------------------------------*/
+static void crcBuildTable(void)
+{
+    for (uint32_t i = 0; i < CRC_TABLE_SIZE; i++)
+    {
+        uint32_t entry = i;
+        for (int bit = 0; bit < BITS_IN_BYTE; bit++)
+        {
+            entry = (entry & 1) ? (entry >> 1) ^ CRC_POLYNOMIAL : entry >> 1;
+        }
+        crc_table[i] = entry;
+    }
+}
+
+static uint32_t crcUpdate(uint32_t checksum, const unsigned char *bytes, long amount)
+{
+    pthread_once(&crc_table_once, crcBuildTable);
+    for (long i = 0; i < amount; i++)
+    {
+        checksum = crc_table[(checksum ^ bytes[i]) & BYTE_MASK] ^ (checksum >> BITS_IN_BYTE);
+    }
+    return checksum;
+}
+
+static void snapshotPutBytes(SnapshotWriter writer, const void *bytes, int amount)
+{
+    writer->checksum = crcUpdate(writer->checksum, bytes, amount);
+    writerPutBytes(writer->writer, bytes, amount);
+}
+
+static unsigned char *snapshotReadFile(FILE *file, long *size)
+{
+    if (fseek(file, 0, SEEK_END) != 0)
+    {
+        return NULL;
+    }
+    *size = ftell(file);
+    if (*size <= 0 || fseek(file, 0, SEEK_SET) != 0)
+    {
+        return NULL;
+    }
+    unsigned char *data = malloc(*size);
+    CHECK_NULL_RETURN(data);
+    if (fread(data, 1, *size, file) != (size_t)*size)
+    {
+        free(data);
+        return NULL;
+    }
+    return data;
+}
@@ -0,0 +1,165 @@
+#ifndef _CHESS_SNAPSHOT_H
+#define _CHESS_SNAPSHOT_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "./chessSystem.h"
+
+/* ----------------------------------------------------------------------
+
+                         Snapshot file format
+
+------------------------------------------------------------------------*/
+/*
+ * A snapshot file is:
+ *   magic        - the 4 bytes "CHSS"
+ *   version      - int(SNAPSHOT_VERSION)
+ *   payload      - ints and strings written by the modules' *SaveSnapshot functions
+ *   checksum     - CRC-32 of everything before it, as an unsigned int
+ * An int is 4 bytes, least significant first. A string is its length(int) followed by its characters.
+ */
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_INT_SIZE 4
+
+/* ----------------------------------------------------------------------
+
+                         Data structs declerations
+
+------------------------------------------------------------------------*/
+/** Writes a snapshot file(through a ChessWriter), keeping its checksum */
+typedef struct snapshot_writer_t *SnapshotWriter;
+
+/** Reads a snapshot file that was fully loaded and verified when the reader was created */
+typedef struct snapshot_reader_t *SnapshotReader;
+
+/* ----------------------------------------------------------------------
+
+                         Header functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Creates a snapshot writer over a given open, writable(binary) file, and writes the snapshot header
+ *
+ * @param file
+ * @return SnapshotWriter(NULL if file is NULL or an allocation failed)
+ */
+SnapshotWriter snapshotCreateWriter(FILE* file);
+
+/**
+ * @brief Writes an int to a snapshot
+ *
+ * @param writer
+ * @param value
+ */
+void snapshotPutInt(SnapshotWriter writer, int value);
+
+/**
+ * @brief Writes a string to a snapshot
+ *
+ * @param writer
+ * @param str
+ */
+void snapshotPutString(SnapshotWriter writer, const char* str);
+
+/**
+ * @brief Writes the snapshot's checksum, and frees the writer(the file stays open)
+ *
+ * @param writer
+ * @return
+ * CHESS_SAVE_FAILURE - if writing to the file failed at any point
+ * CHESS_SUCCESS
+ */
+ChessResult snapshotDestroyWriter(SnapshotWriter writer);
+
+/**
+ * @brief Creates a snapshot reader over a given open, readable(binary) file. The whole file is read,
+ * and its header and checksum are verified
+ *
+ * @param file
+ * @return SnapshotReader(NULL if the file is not a valid snapshot of this version, or an allocation failed)
+ */
+SnapshotReader snapshotCreateReader(FILE* file);
+
+/**
+ * @brief Reads an int from a snapshot
+ *
+ * @param reader
+ * @return The value read(0 if the snapshot ended, and the reader is marked as failed)
+ */
+int snapshotGetInt(SnapshotReader reader);
+
+/**
+ * @brief Reads an amount of items from a snapshot, making sure the rest of the snapshot can hold them
+ *
+ * @param reader
+ * @param item_size - minimal size in bytes of each item
+ * @return The amount read(0 if it is negative or too large, and the reader is marked as failed)
+ */
+int snapshotGetCount(SnapshotReader reader, int item_size);
+
+/**
+ * @brief Reads a string from a snapshot
+ *
+ * @param reader
+ * @return A newly allocated copy of the string(NULL on failure, and the reader is marked as failed)
+ */
+char* snapshotGetString(SnapshotReader reader);
+
+/**
+ * @brief Checks that every read from a snapshot succeeded and that the whole payload was read
+ *
+ * @param reader
+ * @return true
+ * @return false
+ */
+bool snapshotReadComplete(SnapshotReader reader);
+
+/**
+ * @brief Frees a snapshot reader(the file stays open)
+ *
+ * @param reader
+ */
+void snapshotDestroyReader(SnapshotReader reader);
+
+/**
+ * @brief Encodes an unsigned int the way snapshots store it(SNAPSHOT_INT_SIZE bytes, least significant first)
+ *
+ * @param value
+ * @param bytes - at least SNAPSHOT_INT_SIZE bytes
+ */
+void snapshotEncodeUnsigned(uint32_t value, unsigned char* bytes);
+
+/**
+ * @brief Decodes an unsigned int encoded by snapshotEncodeUnsigned
+ *
+ * @param bytes
+ * @return uint32_t
+ */
+uint32_t snapshotDecodeUnsigned(const unsigned char* bytes);
+
+/**
+ * @brief Encodes an int the way snapshots store it(SNAPSHOT_INT_SIZE bytes, least significant first)
+ *
+ * @param value
+ * @param bytes - at least SNAPSHOT_INT_SIZE bytes
+ */
+void snapshotEncodeInt(int value, unsigned char* bytes);
+
+/**
+ * @brief Decodes an int encoded by snapshotEncodeInt
+ *
+ * @param bytes
+ * @return int
+ */
+int snapshotDecodeInt(const unsigned char* bytes);
+
+/**
+ * @brief Calculates the CRC-32 of given bytes(the checksum snapshots end with)
+ *
+ * @param bytes
+ * @param amount
+ * @return uint32_t
+ */
+uint32_t snapshotChecksum(const void* bytes, long amount);
+
+#endif
@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200809L
 #include "./chessReturnsMacros.h"
 #include "./chessPlayerStats.h"
 #include "./mtm_map/map.h"
@@ -8,10 +9,22 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "./chessTournament.h"
+#include "./chessWriter.h"
+#include "./chessSnapshot.h"
+#include "./chessLog.h"
+#include "./chessImport.h"
+#include "./chessWorkers.h"
+#include "./chessLocks.h"
 #define WINNER_NOT_DECIDED -1
 #define STATS_NOT_CALCULATED -1
 #define PLAYER_REMOVED -1
+#define IMPORT_BATCH_SIZE 65536
+#define COMPACTION_CHURN_FACTOR 2
+#define SNAPSHOT_TEMP_SUFFIX ".tmp"
+#define VALUES_AMOUNT(values) ((int)(sizeof(values) / sizeof((values)[0])))
 
 
 
@@ -25,11 +38,92 @@
 
 /** Struct used for pointing at a chess tournaments managing system details
  * @param system_tournaments - holds the generic data type structure of the system's tournaments(Map)
+ * @param players_system_stats - holds every player's stats summed over all of the system's tournaments
+ * @param players_tournaments - holds for every player the ids of the tournaments he has games in(an IdSet per player)
+ * @param players_levels - the players' system stats ordered by level(the order of the players levels file)
+ * @param log - the log the system's changes are recorded in(NULL if none is attached)
+ * @param log_sequence - amount of changes applied to the system since it was first created(kept in snapshots)
+ * @param ingest_threads - amount of threads chessAddGames adds the games of different tournaments on
+ * @param removals_since_compaction - amount of tournament and player removals since the system maps were last compacted
+ * @param locks - the system's locks(NULL unless the system is thread safe)
  */
 struct chess_system_t
 {
     Map system_tournaments;
     Map players_system_stats;
+    Map players_tournaments;
+    IntrusiveMap players_levels;
+    ChessLog log;
+    int log_sequence;
+    int ingest_threads;
+    int removals_since_compaction;
+    ChessLocks locks;
+};
+
+/** Struct used for ordering the games of a chessAddGames batch by tournament
+ * @param tournament_id - the game's tournament
+ * @param index - the game's place in the batch
+ */
+struct batch_game_t
+{
+    int tournament_id;
+    int index;
+};
+
+/** Struct used for summing a player's results in a tournament from the games a chessAddGames batch added
+ * @param player_id
+ * @param tournament_id
+ * @param wins
+ * @param losses
+ * @param draws
+ * @param time_played
+ */
+struct batch_result_t
+{
+    int player_id;
+    int tournament_id;
+    int wins;
+    int losses;
+    int draws;
+    int time_played;
+};
+
+/** Struct used for pointing at the games of a single tournament in a chessAddGames batch
+ * @param tournament - the games tournament(NULL if it does not exist)
+ * @param start - place of the tournament's first game in the batch's order
+ * @param amount - amount of the tournament's games
+ * @param results_amount - amount of results the tournament's games filled
+ */
+struct batch_group_t
+{
+    ChessTournament tournament;
+    int start;
+    int amount;
+    int results_amount;
+};
+
+/** Struct used for pointing at a chessAddGames batch, shared by the workers adding its games
+ * @param games
+ * @param order - the games ordered by tournament
+ * @param groups - the batch's tournaments, each with its games in order
+ * @param groups_amount
+ * @param per_game_results
+ * @param results - room for two results per game(a tournament's results are filled from twice its start)
+ * @param schedule - the groups in the order the workers take them(the most games first)
+ * @param next_group - place in schedule of the next group a worker takes
+ * @param schedule_lock - held while a worker takes a group
+ */
+struct batch_t
+{
+    const ChessGameRecord *games;
+    const struct batch_game_t *order;
+    struct batch_group_t *groups;
+    int groups_amount;
+    ChessResult *per_game_results;
+    struct batch_result_t *results;
+    struct batch_group_t **schedule;
+    int next_group;
+    pthread_mutex_t schedule_lock;
 };
 /* ----------------------------------------------------------------------
 
@@ -122,6 +216,20 @@ static void chessUpdateSystemGameResult(ChessSystem chess,int first_player,int s
  * @return ChessResult 
  */
 static ChessResult chessRemovePlayerStats(ChessSystem chess, int player_id);
+/**
+ * @brief Links a player's system stats into the system's levels(in the place matching the stats)
+ * 
+ * @param chess 
+ * @param stats 
+ */
+static void chessLevelsLink(ChessSystem chess, PlayerStats stats);
+/**
+ * @brief Unlinks a player's system stats from the system's levels[must be called before the stats change]
+ * 
+ * @param chess 
+ * @param stats 
+ */
+static void chessLevelsUnlink(ChessSystem chess, PlayerStats stats);
 /**
  * @brief Converts MapResult(map.h enum) values to corresponding values of ChessResult(chessSystem.h enum)
  * 
@@ -155,11 +263,43 @@ static void chessAddPlayTimeToBothPlayerStats(ChessSystem chess,int firts_player
  */
 static ChessResult chessAddValidTournament(ChessSystem chess, int tournament_id, int max_games_per_player, const char *tournament_location);
 /**
- * @brief Delets a players system stats record
+ * @brief Delets a players system stats record(and the players' tournaments record)
  * 
  * @param chess 
  */
 static void chessDeleteSystemPlayersStats(ChessSystem chess);
+/**
+ * @brief Creates an empty set of tournament ids for a player newly added to the players' tournaments record[used as the map's init function of mapGetOrInsert]
+ * 
+ * @param player_id key of the new player(unused)
+ * @return IdSet of tournament ids(NULL if allocation failed)
+ */
+static IdSet initPlayerTournaments(MapKeyElement player_id);
+/**
+ * @brief Records that both players of a game have games in the given tournament
+ * 
+ * @param chess 
+ * @param tournament_id 
+ * @param first_player 
+ * @param second_player 
+ */
+static void chessLinkBothPlayersToTournament(ChessSystem chess, int tournament_id, int first_player, int second_player);
+/**
+ * @brief Records that a player has games in the given tournament
+ * 
+ * @param chess 
+ * @param tournament_id 
+ * @param player_id 
+ */
+static void chessLinkPlayerToTournament(ChessSystem chess, int tournament_id, int player_id);
+/**
+ * @brief Erases a tournament from a player's tournaments record(and the player's record once it is empty)
+ * 
+ * @param chess 
+ * @param tournament_id 
+ * @param player_key 
+ */
+static void chessUnlinkPlayerFromTournament(ChessSystem chess, int tournament_id, MapKeyElement player_key);
 /**
  * @brief Returns a list containing the system's players levels and ranks
  * 
@@ -184,186 +324,1740 @@ static void chessCheckAddBothPlayersSystem(ChessSystem chess, int first_player,
 static void checkAddPlayerSystem(ChessSystem chess, int player);
 /**
  * @brief Updates players system stats according to a removed tournament(deletes their preformance in the tournament)
+ * and erases the tournament from its players' tournaments record
  * 
  * @param chess 
  * @param tournament 
+ * @param tournament_id 
  */
-static void chessUpdateSystemPlayersStatsRemoveTournament(ChessSystem chess,ChessTournament tournament);
+static void chessUpdateSystemPlayersStatsRemoveTournament(ChessSystem chess,ChessTournament tournament,int tournament_id);
 /**
- * @brief Returns the Player total games played in a given system
+ * @brief Counts a removal, and once the removals since the last compaction pass half of the system's tournaments
+ * and players, relocates the tournaments and players stats maps' entries and id keys into contiguous memory
+ * (after the removals scattered them). Rebuilding only then keeps a removal's cost amortized to its own entries
  * 
- * @param chess_sys 
- * @param player_id 
- * @return int 
+ * @param chess 
  */
-static int chessGetPlayerTotalGamesInSystem(ChessSystem chess_sys,int player_id);
-
+static void chessCompactSystemMaps(ChessSystem chess);
 
-/* ----------------------------------------------------------------------
+/**
+ * @brief Reads the tournaments written by chessSaveSnapshot into a chess system, linking their players to them
+ * 
+ * @param chess 
+ * @param reader 
+ * @return 
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SAVE_FAILURE - if the snapshot holds an invalid tournament
+ * CHESS_SUCCESS
+ */
+static ChessResult chessLoadTournamentsSnapshot(ChessSystem chess, SnapshotReader reader);
 
-                        header-included function's defenitions
+/**
+ * @brief Reads the players system stats written by chessSaveSnapshot into a chess system, linking them into its levels
+ * 
+ * @param chess 
+ * @param reader 
+ * @return 
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SAVE_FAILURE - if the snapshot holds the same player twice
+ * CHESS_SUCCESS
+ */
+static ChessResult chessLoadPlayersStatsSnapshot(ChessSystem chess, SnapshotReader reader);
 
-------------------------------------------------------------------------*/
-ChessSystem chessCreate()
-{
-    ChessSystem new_chess_system = malloc(sizeof(struct chess_system_t));
-    CHECK_NULL_RETURN(new_chess_system);
-    chessInitiateSystemVariables(new_chess_system);
-    
-    return new_chess_system;
-}
+/**
+ * @brief Counts a change applied to a chess system, and records it in the system's log(if one is attached)
+ * 
+ * @param chess 
+ * @param operation 
+ * @param values - the change's int arguments
+ * @param values_amount 
+ * @param text - the change's string argument(NULL if it has none)
+ * @return 
+ * CHESS_SAVE_FAILURE - if the system's log failed(see logCommit)
+ * CHESS_SUCCESS - also if no log is attached
+ */
+static ChessResult chessLogOperation(ChessSystem chess, LogOperation operation, const int *values, int values_amount, const char *text);
 
-void chessDestroy(ChessSystem chess)
-{
-   
-        CHECK_NULL_VOID(chess);
-        chessDeleteSystemTournaments(chess);
-        chessDeleteSystemPlayersStats(chess);
-        free(chess);
-}
+/**
+ * @brief Counts a change applied to a chess system, and appends it to the current commit of the system's log
+ * (if one is attached)[the caller holds the log lock, and ends the commit]
+ * 
+ * @param chess 
+ * @param operation 
+ * @param values - the change's int arguments
+ * @param values_amount 
+ * @param text - the change's string argument(NULL if it has none)
+ * @return 
+ * CHESS_SAVE_FAILURE - if the system's log failed(see logAppend)
+ * CHESS_SUCCESS - also if no log is attached
+ */
+static ChessResult chessLogAppend(ChessSystem chess, LogOperation operation, const int *values, int values_amount, const char *text);
 
-ChessResult chessAddTournament(ChessSystem chess, int tournament_id, int max_games_per_player, const char *tournament_location)
-{
-    CHESS_CHECK_NULL_RETURN(chess);
-    ChessResult check_result;
+/**
+ * @brief Applies a change read back from a log to a chess system(apply function for logReplay)
+ * 
+ * @param context - the chess system
+ * @param record 
+ * @return 
+ * CHESS_SAVE_FAILURE - if the record is not a valid change, or it does not continue the system's changes
+ * The change's result - if it failed
+ * CHESS_SUCCESS
+ */
+static ChessResult chessApplyLogRecord(void *context, const LogRecord *record);
 
-    
-    check_result = checkValidTournamentId(tournament_id);
-    CHESS_CHECK_NOT_SUCCESS_RETURN(check_result);
+/**
+ * @brief Adds a batch's games of a single tournament in order, and fills both players results of every game added.
+ * Touches nothing but the tournament, so the games of different tournaments may be added at once
+ * 
+ * @param tournament - the games tournament(NULL if it does not exist)
+ * @param games - the whole batch
+ * @param order - the tournament's games, in the order they are added
+ * @param amount - amount of games in order
+ * @param per_game_results 
+ * @param results - filled with two results per game added
+ * @return int - amount of results filled
+ */
+static int chessAddTournamentGames(ChessTournament tournament, const ChessGameRecord *games, const struct batch_game_t *order,
+                                   int amount, ChessResult *per_game_results, struct batch_result_t *results);
 
-    check_result = chessCheckTournamentNotExist(chess, tournament_id);
-    CHESS_CHECK_NOT_SUCCESS_RETURN(check_result);
+/**
+ * @brief Adds the games of the batch's tournaments, taking the next tournament of the batch's schedule
+ * until none is left, so a worker done with a small tournament goes on to the next one[a WorkerFunction]
+ * 
+ * @param batch 
+ * @param worker_index 
+ * @param workers_amount 
+ */
+static void chessAddBatchGroups(void *batch, int worker_index, int workers_amount);
 
-    check_result = isValidLocation(tournament_location);
-    CHESS_CHECK_NOT_SUCCESS_RETURN(check_result);
+/**
+ * @brief Takes the next group of a batch's schedule for a worker
+ * 
+ * @param batch 
+ * @return struct batch_group_t* - the group(NULL if every group was taken)
+ */
+static struct batch_group_t *chessTakeBatchGroup(struct batch_t *batch);
 
-    check_result = checkValidMaxGames(max_games_per_player);
-    CHESS_CHECK_NOT_SUCCESS_RETURN(check_result);
+/**
+ * @brief Logs the games of a batch that were added, in the order they were added in, as a single commit
+ * 
+ * @param chess 
+ * @param games 
+ * @param order 
+ * @param amount 
+ * @param per_game_results 
+ * @return 
+ * CHESS_SAVE_FAILURE - if the system's log failed to record a game
+ * CHESS_SUCCESS
+ */
+static ChessResult chessLogBatchGames(ChessSystem chess, const ChessGameRecord *games, const struct batch_game_t *order,
+                               int amount, const ChessResult *per_game_results);
 
-    return chessAddValidTournament(chess, tournament_id,  max_games_per_player,tournament_location);
-}
+/**
+ * @brief Adds the results of a batch's games to the players system stats, and links the players to the tournaments,
+ * once per player
+ * 
+ * @param chess 
+ * @param results 
+ * @param amount 
+ */
+static void chessApplyBatchResults(ChessSystem chess, struct batch_result_t *results, int amount);
 
-ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player, int second_player, Winner winner, int play_time)
-{
-    CHESS_CHECK_NULL_RETURN(chess);
+/**
+ * @brief Adds a batch of games read from a games file, and reports each game that was not added
+ * 
+ * @param chess 
+ * @param games 
+ * @param lines - the line number of every game
+ * @param amount 
+ * @param results - room for the games results
+ * @param report - updated with the amount of games added and rejected
+ * @param on_error 
+ * @param context 
+ * @return 
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SAVE_FAILURE - if the games were added, but the system's log failed to record them
+ * CHESS_SUCCESS
+ */
+static ChessResult chessImportBatch(ChessSystem chess, const ChessGameRecord *games, const long *lines, int amount,
+                                    ChessResult *results, ChessImportReport *report, ChessImportErrorFunction on_error,
+                                    void *context);
 
-    ChessResult variable_check = checkGameVaraiables(tournament_id, first_player, second_player);
-    CHESS_CHECK_NOT_SUCCESS_RETURN(variable_check);
+/**
+ * @brief Compare function of batch games(by tournament, then by place in the batch)[used by qsort]
+ * 
+ * @param first_game 
+ * @param second_game 
+ * @return int 
+ */
+static int compareBatchGames(const void *first_game, const void *second_game);
 
-    
-    CHESS_CHECK_TOURNAMENT_DOES_EXIST_RETURN(chess,tournament_id);
-    ChessTournament tournament = mapGet((Map)chess->system_tournaments, (MapKeyElement)&tournament_id);
-     
-    variable_check = tournamentAddGame(tournament, first_player, second_player,winner,  play_time);
+/**
+ * @brief Compare function of batch groups(the one with more games first, then by place in the batch)[used by qsort]
+ * 
+ * @param first_group - pointer to a group's pointer
+ * @param second_group - pointer to a group's pointer
+ * @return int 
+ */
+static int compareBatchGroupsBySize(const void *first_group, const void *second_group);
 
-    CHESS_CHECK_NOT_SUCCESS_RETURN(variable_check);
-    
-    chessUpdatePlayersSystemAndTournamentStats(chess,tournament,first_player,second_player,winner,play_time);
+/**
+ * @brief Compare function of batch results(by player, then by tournament)[used by qsort]
+ * 
+ * @param first_result 
+ * @param second_result 
+ * @return int 
+ */
+static int compareBatchResults(const void *first_result, const void *second_result);
 
-    return CHESS_SUCCESS;
-}
+/**
+ * @brief Returns a system's locks
+ * 
+ * @param chess 
+ * @return ChessLocks(NULL if chess is NULL or the system is not thread safe)
+ */
+static ChessLocks chessGetLocks(ChessSystem chess);
 
-ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
-{
-    
-    if (tournament_id <= 0)
-    {
-        return CHESS_INVALID_ID;
-    }
-    if (chess == NULL || chess->system_tournaments == NULL)
-    {
-        return CHESS_NULL_ARGUMENT;
-    }
-    if(!mapContains(chess->system_tournaments, &tournament_id))
-    {
-        return CHESS_TOURNAMENT_NOT_EXIST;
-    }
-    ChessTournament touranament_removed = mapGet(chess->system_tournaments,(MapKeyElement)&tournament_id);
+/**
+ * @brief Locks the whole system(takes the catalog exclusively)
+ * 
+ * @param chess 
+ */
+static void chessLockSystem(ChessSystem chess);
 
-    chessUpdateSystemPlayersStatsRemoveTournament(chess,touranament_removed);
-     return convertMapToChessResultTournament(mapRemove((chess->system_tournaments), (MapKeyElement)&tournament_id));
+/**
+ * @brief Unlocks the whole system
+ * 
+ * @param chess 
+ */
+static void chessUnlockSystem(ChessSystem chess);
 
-}
+/**
+ * @brief Finds a tournament and locks it(under a shared catalog)
+ * 
+ * @param chess 
+ * @param tournament_id 
+ * @return The tournament(NULL if it does not exist, then nothing stays locked)
+ */
+static ChessTournament chessLockTournament(ChessSystem chess, int tournament_id);
 
-ChessResult chessRemovePlayer(ChessSystem chess, int player_id)
-{
-    if (player_id <= 0)
-    {
-        return CHESS_INVALID_ID;
-    }
+/**
+ * @brief Unlocks a tournament locked by chessLockTournament
+ * 
+ * @param chess 
+ * @param tournament 
+ */
+static void chessUnlockTournament(ChessSystem chess, ChessTournament tournament);
 
-    ChessResult current_result = CHESS_PLAYER_NOT_EXIST;
-    ChessResult final_result = CHESS_PLAYER_NOT_EXIST;
+/**
+ * @brief Locks a single player's system stats(under a shared catalog and shared players)
+ * 
+ * @param chess 
+ * @param player_id 
+ */
+static void chessLockPlayer(ChessSystem chess, int player_id);
 
-    MapKeyElement current_key = mapGetFirst(chess->system_tournaments);
-    
-    ChessTournament current_tournament = mapGet(chess->system_tournaments, current_key);
-    while (current_tournament != NULL)
-    {
-        current_result = removePlayerFromTournament(current_tournament, player_id,chess->players_system_stats);
-        if (current_result == CHESS_SUCCESS)
-        {
-            final_result = CHESS_SUCCESS;
-        }
-         freeIdKey(current_key);
-        current_key = mapGetNext(chess->system_tournaments);
-       
-        current_tournament = mapGet(chess->system_tournaments, current_key);
-    }
-    chessRemovePlayerStats(chess,player_id);
-    freeIdKey(current_key);
+/**
+ * @brief Unlocks a player locked by chessLockPlayer
+ * 
+ * @param chess 
+ * @param player_id 
+ */
+static void chessUnlockPlayer(ChessSystem chess, int player_id);
 
-    return final_result;
-}
+/**
+ * @brief Locks the players levels(under a shared catalog and shared players)
+ * 
+ * @param chess 
+ */
+static void chessLockLevels(ChessSystem chess);
 
-ChessResult chessEndTournament (ChessSystem chess, int
-tournament_id)
-{
-    CHESS_CHECK_NULL_RETURN(chess);
-    ChessResult result = checkValidTournamentId(tournament_id);
-    CHESS_CHECK_NOT_SUCCESS_RETURN(result);
-    CHESS_CHECK_TOURNAMENT_DOES_EXIST_RETURN(chess,tournament_id);
-    ChessTournament tournament = mapGet(chess->system_tournaments,&tournament_id);
-    if(tournament == NULL)
-    {
-        return CHESS_TOURNAMENT_NOT_EXIST;
-    }
-    return tournamentSetEnded(tournament);
-}
+/**
+ * @brief Unlocks the players levels locked by chessLockLevels
+ * 
+ * @param chess 
+ */
+static void chessUnlockLevels(ChessSystem chess);
 
-double chessCalculateAveragePlayTime (ChessSystem chess, int
-player_id, ChessResult* chess_result)
-{
-    if(chess == NULL)
-    {
-        *chess_result = CHESS_NULL_ARGUMENT;
-        return (double)STATS_NOT_CALCULATED;
-    }
-    if(player_id < 0)
-    {
-        *chess_result = CHESS_INVALID_ID;
-        return (double)STATS_NOT_CALCULATED;
-    }
-    
-    PlayerStats player_system_stats = chessGetPlayerStats(chess,player_id);
-    if(player_system_stats == NULL)
-        {
-           *chess_result = CHESS_PLAYER_NOT_EXIST;
-            return (double)STATS_NOT_CALCULATED; 
-        }
+/**
+ * @brief Returns a tournament of the system(read only lookup if the system is thread safe)
+ * 
+ * @param chess 
+ * @param tournament_id 
+ * @return ChessTournament(NULL if it does not exist)
+ */
+static ChessTournament chessGetTournament(ChessSystem chess, int tournament_id);
 
-    
-    int total_time = statsGetTime(player_system_stats);
-    int total_games = chessGetPlayerTotalGamesInSystem(chess,player_id);
-    double average = total_time/(double)total_games;
+/**
+ * @brief Adds a game that was added to a tournament to both players system stats and tournaments record.
+ * In a thread safe system, players who are already in the system are updated under their stripes only
+ * 
+ * @param chess 
+ * @param tournament 
+ * @param tournament_id 
+ * @param first_player 
+ * @param second_player 
+ * @param winner 
+ * @param play_time 
+ */
+static void chessAddGameToPlayers(ChessSystem chess, ChessTournament tournament, int tournament_id, int first_player,
+                                  int second_player, Winner winner, int play_time);
+
+/**
+ * @brief Adds a tournament to the system[the caller holds the whole system]
+ * 
+ * @param chess 
+ * @param tournament_id 
+ * @param max_games_per_player 
+ * @param tournament_location 
+ * @return ChessResult 
+ */
+static ChessResult chessAddTournamentLocked(ChessSystem chess, int tournament_id, int max_games_per_player, const char *tournament_location);
+
+/**
+ * @brief Adds a batch of games to the system[the caller holds the whole system]
+ * 
+ * @param chess 
+ * @param games 
+ * @param n 
+ * @param per_game_results 
+ * @return ChessResult 
+ */
+static ChessResult chessAddGamesLocked(ChessSystem chess, const ChessGameRecord *games, int n, ChessResult *per_game_results);
+
+/**
+ * @brief Removes a tournament from the system[the caller holds the whole system]
+ * 
+ * @param chess 
+ * @param tournament_id 
+ * @return ChessResult 
+ */
+static ChessResult chessRemoveTournamentLocked(ChessSystem chess, int tournament_id);
+
+/**
+ * @brief Removes a player from the system[the caller holds the whole system]
+ * 
+ * @param chess 
+ * @param player_id 
+ * @return ChessResult 
+ */
+static ChessResult chessRemovePlayerLocked(ChessSystem chess, int player_id);
+
+/**
+ * @brief Calculates a player's average game time in the system[the caller holds the player's stripe]
+ * 
+ * @param chess 
+ * @param player_id 
+ * @param chess_result 
+ * @return double 
+ */
+static double chessCalculateAveragePlayTimeLocked(ChessSystem chess, int player_id, ChessResult *chess_result);
+
+/**
+ * @brief Writes every player's level to a file[the caller holds the players levels]
+ * 
+ * @param chess 
+ * @param file 
+ * @return ChessResult 
+ */
+static ChessResult chessSavePlayersLevelsLocked(ChessSystem chess, FILE *file);
+
+/**
+ * @brief Writes the levels of the k highest players to a file[the caller holds the players levels]
+ * 
+ * @param chess 
+ * @param k 
+ * @param file 
+ * @return ChessResult 
+ */
+static ChessResult chessSavePlayersLevelsTopKLocked(ChessSystem chess, int k, FILE *file);
+
+/**
+ * @brief Returns a player's place in the players levels[the caller holds the players levels]
+ * 
+ * @param chess 
+ * @param player_id 
+ * @param chess_result 
+ * @return int 
+ */
+static int chessGetPlayerRankLocked(ChessSystem chess, int player_id, ChessResult *chess_result);
+
+/**
+ * @brief Returns the id of the player at a given place in the players levels[the caller holds the players levels]
+ * 
+ * @param chess 
+ * @param rank 
+ * @param chess_result 
+ * @return int 
+ */
+static int chessGetPlayerAtRankLocked(ChessSystem chess, int rank, ChessResult *chess_result);
+
+/**
+ * @brief Writes the statistics of the ended tournaments to a file[the caller holds the whole system]
+ * 
+ * @param chess 
+ * @param path_file 
+ * @return ChessResult 
+ */
+static ChessResult chessSaveTournamentStatisticsLocked(ChessSystem chess, char *path_file);
+
+/**
+ * @brief Writes a snapshot of the system to a file[the caller holds the whole system]. The snapshot is written
+ * to path_file followed by SNAPSHOT_TEMP_SUFFIX, synced, and only then renamed over path_file, so a crash
+ * while saving leaves the previous snapshot whole
+ * 
+ * @param chess 
+ * @param path_file 
+ * @return ChessResult 
+ */
+static ChessResult chessSaveSnapshotLocked(ChessSystem chess, const char *path_file);
+
+/**
+ * @brief Writes a snapshot of the system to an open file, and waits until it is on disk
+ * 
+ * @param chess 
+ * @param file 
+ * @return 
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SAVE_FAILURE - if writing or syncing the file failed
+ * CHESS_SUCCESS
+ */
+static ChessResult chessWriteSnapshot(ChessSystem chess, FILE *file);
+
+/**
+ * @brief Opens a log for the system[the caller holds the whole system]
+ * 
+ * @param chess 
+ * @param path_file 
+ * @param policy 
+ * @param batch_size 
+ * @return ChessResult 
+ */
+static ChessResult chessAttachLogLocked(ChessSystem chess, const char *path_file, ChessLogSyncPolicy policy, int batch_size);
+
+/**
+ * @brief Closes the system's log[the caller holds the whole system]
+ * 
+ * @param chess 
+ * @return ChessResult 
+ */
+static ChessResult chessDetachLogLocked(ChessSystem chess);
+
+
+/* ----------------------------------------------------------------------
+
+                        header-included function's defenitions
+
+------------------------------------------------------------------------*/
+ChessSystem chessCreate()
+{
+    ChessSystem new_chess_system = malloc(sizeof(struct chess_system_t));
+    CHECK_NULL_RETURN(new_chess_system);
+    chessInitiateSystemVariables(new_chess_system);
+    
+    return new_chess_system;
+}
+
+void chessDestroy(ChessSystem chess)
+{
+   
+        CHECK_NULL_VOID(chess);
+        logClose(chess->log);
+        locksDestroy(chess->locks);
+        chessDeleteSystemTournaments(chess);
+        chessDeleteSystemPlayersStats(chess);
+        free(chess);
+}
+
+ChessResult chessAddTournament(ChessSystem chess, int tournament_id, int max_games_per_player, const char *tournament_location)
+{
+    chessLockSystem(chess);
+    ChessResult result = chessAddTournamentLocked(chess,tournament_id,max_games_per_player,tournament_location);
+    chessUnlockSystem(chess);
+    return result;
+}
+
+ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player, int second_player, Winner winner, int play_time)
+{
+    CHESS_CHECK_NULL_RETURN(chess);
+
+    ChessResult variable_check = checkGameVaraiables(tournament_id, first_player, second_player);
+    CHESS_CHECK_NOT_SUCCESS_RETURN(variable_check);
+
+    
+    ChessTournament tournament = chessLockTournament(chess,tournament_id);
+    CHESS_CHECK_TOURNAMENT_FOUND_RETURN(tournament);
+     
+    variable_check = tournamentAddGame(tournament, first_player, second_player,winner,  play_time);
+    if(variable_check == CHESS_SUCCESS)
+    {
+        chessAddGameToPlayers(chess,tournament,tournament_id,first_player,second_player,winner,play_time);
+        int values[] = {tournament_id, first_player, second_player, winner, play_time};
+        variable_check = chessLogOperation(chess,LOG_ADD_GAME,values,VALUES_AMOUNT(values),NULL);
+    }
+    chessUnlockTournament(chess,tournament);
+    return variable_check;
+}
+
+ChessResult chessAddGames(ChessSystem chess, const ChessGameRecord* games, int n, ChessResult* per_game_results)
+{
+    chessLockSystem(chess);
+    ChessResult result = chessAddGamesLocked(chess,games,n,per_game_results);
+    chessUnlockSystem(chess);
+    return result;
+}
+
+ChessResult chessSetIngestThreads(ChessSystem chess, int threads)
+{
+    CHESS_CHECK_NULL_RETURN(chess);
+    chessLockSystem(chess);
+    chess->ingest_threads = (threads < 1) ? 1 : threads;
+    chessUnlockSystem(chess);
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessEnableThreadSafety(ChessSystem chess)
+{
+    CHESS_CHECK_NULL_RETURN(chess);
+    if(chess->locks == NULL)
+    {
+        chess->locks = locksCreate();
+    }
+    return (chess->locks == NULL) ? CHESS_OUT_OF_MEMORY : CHESS_SUCCESS;
+}
+
+ChessResult chessImportGamesFile(ChessSystem chess, const char* path_file, ChessImportReport* report,
+                                 ChessImportErrorFunction on_error, void* context)
+{
+    CHESS_CHECK_NULL_RETURN(chess);
+    CHESS_CHECK_NULL_RETURN(path_file);
+    ImportFile file = importOpen(path_file);
+    if(file == NULL)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    ChessGameRecord *games = malloc(sizeof(ChessGameRecord) * IMPORT_BATCH_SIZE);
+    long *lines = malloc(sizeof(long) * IMPORT_BATCH_SIZE);
+    ChessResult *results = malloc(sizeof(ChessResult) * IMPORT_BATCH_SIZE);
+    ChessResult import_result = (games == NULL || lines == NULL || results == NULL) ? CHESS_OUT_OF_MEMORY : CHESS_SUCCESS;
+
+    ChessImportReport summary = {0, 0, 0, 0, 0, 0, 0};
+    int amount = 0;
+    ImportLine line = IMPORT_END;
+    while(import_result == CHESS_SUCCESS && (line = importNextGame(file,&games[amount])) != IMPORT_END)
+    {
+        if(line == IMPORT_EMPTY_LINE)
+        {
+            continue;
+        }
+        summary.lines++;
+        if(line == IMPORT_INVALID_LINE)
+        {
+            summary.malformed_lines++;
+            if(on_error != NULL)
+            {
+                on_error(context,importGetLineNumber(file),CHESS_INVALID_ID);
+            }
+            continue;
+        }
+        lines[amount++] = importGetLineNumber(file);
+        if(amount == IMPORT_BATCH_SIZE)
+        {
+            import_result = chessImportBatch(chess,games,lines,amount,results,&summary,on_error,context);
+            amount = 0;
+        }
+    }
+    if(import_result == CHESS_SUCCESS)
+    {
+        import_result = chessImportBatch(chess,games,lines,amount,results,&summary,on_error,context);
+    }
+
+    summary.bytes = importGetSize(file);
+    summary.seconds = importGetElapsedSeconds(file);
+    summary.bytes_per_second = (summary.seconds > 0) ? summary.bytes / summary.seconds : 0;
+    if(report != NULL)
+    {
+        *report = summary;
+    }
+    importClose(file);
+    free(games);
+    free(lines);
+    free(results);
+    return import_result;
+}
+
+ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
+{
+    chessLockSystem(chess);
+    ChessResult result = chessRemoveTournamentLocked(chess,tournament_id);
+    chessUnlockSystem(chess);
+    return result;
+}
+
+ChessResult chessRemovePlayer(ChessSystem chess, int player_id)
+{
+    chessLockSystem(chess);
+    ChessResult result = chessRemovePlayerLocked(chess,player_id);
+    chessUnlockSystem(chess);
+    return result;
+}
+
+ChessResult chessEndTournament (ChessSystem chess, int
+tournament_id)
+{
+    CHESS_CHECK_NULL_RETURN(chess);
+    ChessResult result = checkValidTournamentId(tournament_id);
+    CHESS_CHECK_NOT_SUCCESS_RETURN(result);
+    ChessTournament tournament = chessLockTournament(chess,tournament_id);
+    CHESS_CHECK_TOURNAMENT_FOUND_RETURN(tournament);
+    result = tournamentSetEnded(tournament);
+    if(result == CHESS_SUCCESS)
+    {
+        result = chessLogOperation(chess,LOG_END_TOURNAMENT,&tournament_id,1,NULL);
+    }
+    chessUnlockTournament(chess,tournament);
+    return result;
+}
+
+int chessGetTournamentLeader (ChessSystem chess, int tournament_id, ChessResult* chess_result)
+{
+    if(chess == NULL)
+    {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return STATS_NOT_CALCULATED;
+    }
+    *chess_result = checkValidTournamentId(tournament_id);
+    if(*chess_result != CHESS_SUCCESS)
+    {
+        return STATS_NOT_CALCULATED;
+    }
+    ChessTournament tournament = chessLockTournament(chess,tournament_id);
+    if(tournament == NULL)
+    {
+        *chess_result = CHESS_TOURNAMENT_NOT_EXIST;
+        return STATS_NOT_CALCULATED;
+    }
+
+    int leader_id = tournamentCheckEnded(tournament) ? tournamentGetWinnerId(tournament) : tournamentGetLeaderId(tournament);
+    chessUnlockTournament(chess,tournament);
+    *chess_result = (leader_id == STATS_NOT_CALCULATED) ? CHESS_NO_GAMES : CHESS_SUCCESS;
+    return leader_id;
+}
+
+ChessResult chessGetTournamentStandings (ChessSystem chess, int tournament_id, int top_k, int* player_ids, int* amount)
+{
+    CHESS_CHECK_NULL_RETURN(chess);
+    CHESS_CHECK_NULL_RETURN(player_ids);
+    CHESS_CHECK_NULL_RETURN(amount);
+    ChessResult result = checkValidTournamentId(tournament_id);
+    CHESS_CHECK_NOT_SUCCESS_RETURN(result);
+    ChessTournament tournament = chessLockTournament(chess,tournament_id);
+    CHESS_CHECK_TOURNAMENT_FOUND_RETURN(tournament);
+
+    *amount = tournamentGetStandings(tournament,top_k,player_ids);
+    chessUnlockTournament(chess,tournament);
+    return CHESS_SUCCESS;
+}
+
+double chessCalculateAveragePlayTime (ChessSystem chess, int
+player_id, ChessResult* chess_result)
+{
+    chessLockPlayer(chess,player_id);
+    double average = chessCalculateAveragePlayTimeLocked(chess,player_id,chess_result);
+    chessUnlockPlayer(chess,player_id);
+    return average;
+}
+
+
+ChessResult chessSavePlayersLevels (ChessSystem chess, FILE* file)
+{
+    chessLockLevels(chess);
+    ChessResult result = chessSavePlayersLevelsLocked(chess,file);
+    chessUnlockLevels(chess);
+    return result;
+}
+
+ChessResult chessSavePlayersLevelsTopK (ChessSystem chess, int k, FILE* file)
+{
+    chessLockLevels(chess);
+    ChessResult result = chessSavePlayersLevelsTopKLocked(chess,k,file);
+    chessUnlockLevels(chess);
+    return result;
+}
+
+
+int chessGetPlayerRank (ChessSystem chess, int player_id, ChessResult* chess_result)
+{
+    chessLockLevels(chess);
+    int value = chessGetPlayerRankLocked(chess,player_id,chess_result);
+    chessUnlockLevels(chess);
+    return value;
+}
+
+int chessGetPlayerAtRank (ChessSystem chess, int rank, ChessResult* chess_result)
+{
+    chessLockLevels(chess);
+    int value = chessGetPlayerAtRankLocked(chess,rank,chess_result);
+    chessUnlockLevels(chess);
+    return value;
+}
+
+/* ----------------------------------------------------------------------
+
+             non header-included function's defenitions(aid functions)
+
+------------------------------------------------------------------------*/
+
+static ChessResult chessRemovePlayerStats(ChessSystem chess, int player_id)
+{
+      if(chess == NULL)
+      {
+          return CHESS_NULL_ARGUMENT;
+      }
+    
+        if(player_id <= 0)
+        {
+            return CHESS_INVALID_ID;
+        }
+
+   
+    chessLevelsUnlink(chess,chessGetPlayerStats(chess,player_id));
+    return chessConvertMapToChessResult(mapRemove(chess->players_system_stats,&player_id));
+}
+
+static void chessDeleteSystemTournaments(ChessSystem chess)
+{
+    CHECK_NULL_VOID(chess);
+    mapDestroy(chess->system_tournaments);
+}
+
+static ChessResult chessAddValidTournament(ChessSystem chess, int tournament_id, int max_games_per_player, const char *tournament_location)
+{
+    ChessTournament new_tournament = createTournamentValid(max_games_per_player, tournament_location);
+    mapPut(chess->system_tournaments, &tournament_id, new_tournament);
+    freeTournament(new_tournament);
+    return CHESS_SUCCESS;
+}
+
+static void chessInitiateSystemVariables(ChessSystem new_chess_system)
+{
+    new_chess_system->system_tournaments = mapCreate((copyMapDataElements)copyTournament, copyIdKey, (freeMapDataElements)freeTournament, freeIdKey, (compareMapKeyElements)(compareIdKeys));
+    new_chess_system->players_system_stats = mapCreate((copyMapDataElements)copyPlayerStats,(copyMapKeyElements)copyIdKey, 
+    (freeMapDataElements)freePlayerStats, (freeMapKeyElements)freeIdKey, (compareMapKeyElements)compareIdKeys);
+    mapEnableFilter(new_chess_system->system_tournaments, hashIdKey);
+    mapEnableFilter(new_chess_system->players_system_stats, hashIdKey);
+    mapEnableFinger(new_chess_system->system_tournaments);
+    mapEnableFinger(new_chess_system->players_system_stats);
+    intrusiveMapInit(&new_chess_system->players_levels, statsGetStandingKey, statsCompareLevels);
+    new_chess_system->players_tournaments = mapCreate((copyMapDataElements)idSetCopy, (copyMapKeyElements)copyIdKey,
+    (freeMapDataElements)idSetDestroy, (freeMapKeyElements)freeIdKey, (compareMapKeyElements)compareIdKeys);
+    mapEnableFilter(new_chess_system->players_tournaments, hashIdKey);
+    new_chess_system->log = NULL;
+    new_chess_system->log_sequence = 0;
+    new_chess_system->ingest_threads = 1;
+    new_chess_system->removals_since_compaction = 0;
+    new_chess_system->locks = NULL;
+}
+
+
+
+static void chessUpdateSystemPlayersStatsRemoveTournament(ChessSystem chess,ChessTournament tournament,int tournament_id)
+{
+     CHECK_NULL_VOID(chess);
+     CHECK_NULL_VOID(tournament);
+
+    int players_amount = tournamentGetPlayersAmount(tournament);
+    if(players_amount <= 0)
+    {
+        return;
+    }
+    MapKeyElement* player_keys = malloc(sizeof(MapKeyElement) * players_amount);
+    PlayerStats* tournament_stats = malloc(sizeof(PlayerStats) * players_amount);
+    PlayerStats* system_stats = malloc(sizeof(PlayerStats) * players_amount);
+    if(player_keys != NULL && tournament_stats != NULL && system_stats != NULL)
+    {
+        int collected = 0;
+        MapKeyElement current_player_key = tournamentGetFirstPlayerKeyCopy(tournament);
+        while(current_player_key != NULL && collected < players_amount)
+        {
+            player_keys[collected++] = current_player_key;
+            current_player_key = tournamentGetNextPlayerKeyCopy(tournament);
+        }
+        freeIdKey(current_player_key);
+
+        if(tournamentGetPlayersStats(tournament,player_keys,collected,tournament_stats) == CHESS_SUCCESS &&
+           mapGetMany(chess->players_system_stats,player_keys,collected,(MapDataElement*)system_stats) == MAP_SUCCESS)
+        {
+            for(int i = 0; i < collected; i++)
+            {
+                chessLevelsUnlink(chess,system_stats[i]);
+                statsSubtractStats(system_stats[i],tournament_stats[i]);
+                chessLevelsLink(chess,system_stats[i]);
+            }
+        }
+        for(int i = 0; i < collected; i++)
+        {
+            chessUnlinkPlayerFromTournament(chess,tournament_id,player_keys[i]);
+            freeIdKey(player_keys[i]);
+        }
+    }
+    free(player_keys);
+    free(tournament_stats);
+    free(system_stats);
+}
+
+
+
+static void checkAddPlayerSystem(ChessSystem chess, int player)
+{
+    if(player == PLAYER_REMOVED)
+    {
+        return;
+    }
+    bool created = false;
+    PlayerStats stats = mapGetOrInsert(chess->players_system_stats, (MapKeyElement)&player,
+                                       (initMapDataElements)initPlayerStats, &created);
+    if(created)
+    {
+        chessLevelsLink(chess,stats);
+    }
+}
+
+ChessResult chessSaveTournamentStatistics (ChessSystem chess, char*
+path_file)
+{
+    chessLockSystem(chess);
+    ChessResult result = chessSaveTournamentStatisticsLocked(chess,path_file);
+    chessUnlockSystem(chess);
+    return result;
+}
+
+ChessResult chessSaveSnapshot (ChessSystem chess, const char* path_file)
+{
+    chessLockSystem(chess);
+    ChessResult result = chessSaveSnapshotLocked(chess,path_file);
+    chessUnlockSystem(chess);
+    return result;
+}
+
+ChessSystem chessLoadSnapshot (const char* path_file)
+{
+    CHECK_NULL_RETURN(path_file);
+    FILE *fptr = fopen(path_file,"rb");
+    CHECK_NULL_RETURN(fptr);
+    SnapshotReader reader = snapshotCreateReader(fptr);
+    fclose(fptr);
+    CHECK_NULL_RETURN(reader);
+
+    ChessSystem new_chess_system = chessCreate();
+    if(new_chess_system != NULL)
+    {
+        new_chess_system->log_sequence = snapshotGetInt(reader);
+    }
+    if(new_chess_system == NULL ||
+       chessLoadTournamentsSnapshot(new_chess_system,reader) != CHESS_SUCCESS ||
+       chessLoadPlayersStatsSnapshot(new_chess_system,reader) != CHESS_SUCCESS ||
+       !snapshotReadComplete(reader))
+    {
+        chessDestroy(new_chess_system);
+        new_chess_system = NULL;
+    }
+    snapshotDestroyReader(reader);
+    return new_chess_system;
+}
+
+ChessResult chessAttachLog (ChessSystem chess, const char* path_file, ChessLogSyncPolicy policy, int batch_size)
+{
+    chessLockSystem(chess);
+    ChessResult result = chessAttachLogLocked(chess,path_file,policy,batch_size);
+    chessUnlockSystem(chess);
+    return result;
+}
+
+ChessResult chessSyncLog (ChessSystem chess)
+{
+    CHESS_CHECK_NULL_RETURN(chess);
+    locksLockLog(chess->locks);
+    ChessResult result = (chess->log == NULL) ? CHESS_NULL_ARGUMENT : logSync(chess->log);
+    locksUnlockLog(chess->locks);
+    return result;
+}
+
+ChessResult chessDetachLog (ChessSystem chess)
+{
+    chessLockSystem(chess);
+    ChessResult result = chessDetachLogLocked(chess);
+    chessUnlockSystem(chess);
+    return result;
+}
+
+ChessSystem chessRecover (const char* snapshot_path, const char* log_path)
+{
+    CHECK_NULL_RETURN(log_path);
+    ChessSystem recovered_chess = (snapshot_path != NULL) ? chessLoadSnapshot(snapshot_path) : chessCreate();
+    CHECK_NULL_RETURN(recovered_chess);
+    if(logReplay(log_path,recovered_chess->log_sequence,chessApplyLogRecord,recovered_chess) != CHESS_SUCCESS)
+    {
+        chessDestroy(recovered_chess);
+        return NULL;
+    }
+    return recovered_chess;
+}
+
+
+
+static void chessCompactSystemMaps(ChessSystem chess)
+{
+    CHECK_NULL_VOID(chess);
+    chess->removals_since_compaction++;
+    int entries = mapGetSize(chess->system_tournaments) + mapGetSize(chess->players_system_stats);
+    if(chess->removals_since_compaction * COMPACTION_CHURN_FACTOR <= entries)
+    {
+        return;
+    }
+    mapRebuild(chess->system_tournaments, sizeof(int), 0);
+    mapRebuild(chess->players_system_stats, sizeof(int), 0);
+    chess->removals_since_compaction = 0;
+}
+
+static void chessLevelsLink(ChessSystem chess, PlayerStats stats)
+{
+    CHECK_NULL_VOID(chess);
+    statsLinkStanding(&chess->players_levels,stats);
+}
+
+static void chessLevelsUnlink(ChessSystem chess, PlayerStats stats)
+{
+    CHECK_NULL_VOID(chess);
+    statsUnlinkStanding(&chess->players_levels,stats);
+}
+
+static void chessDeleteSystemPlayersStats(ChessSystem chess)
+{
+    CHECK_NULL_VOID(chess);
+    mapDestroy(chess->players_system_stats);
+    mapDestroy(chess->players_tournaments);
+}
+
+static IdSet initPlayerTournaments(MapKeyElement player_id)
+{
+    (void)player_id;
+    return idSetCreate();
+}
+
+static void chessLinkBothPlayersToTournament(ChessSystem chess, int tournament_id, int first_player, int second_player)
+{
+    chessLinkPlayerToTournament(chess,tournament_id,first_player);
+    chessLinkPlayerToTournament(chess,tournament_id,second_player);
+}
+
+static void chessLinkPlayerToTournament(ChessSystem chess, int tournament_id, int player_id)
+{
+    CHECK_NULL_VOID(chess);
+    IdSet player_tournaments = mapGetOrInsert(chess->players_tournaments, (MapKeyElement)&player_id,
+                                              (initMapDataElements)initPlayerTournaments, NULL);
+    idSetAdd(player_tournaments, tournament_id);
+}
+
+static void chessUnlinkPlayerFromTournament(ChessSystem chess, int tournament_id, MapKeyElement player_key)
+{
+    CHECK_NULL_VOID(chess);
+    IdSet player_tournaments = mapGet(chess->players_tournaments, player_key);
+    CHECK_NULL_VOID(player_tournaments);
+    idSetRemove(player_tournaments, tournament_id);
+    if(idSetGetSize(player_tournaments) == 0)
+    {
+        mapRemove(chess->players_tournaments, player_key);
+    }
+}
+
+
+
+
+static void chessCheckAddBothPlayersSystem(ChessSystem chess, int first_player, int second_player)
+{
+    checkAddPlayerSystem(chess,first_player);
+    checkAddPlayerSystem(chess,second_player);
+}
+
+
+
+
+static PlayerRank insertLevelsIds(ChessSystem chess)
+{
+    int players_amount = mapConstGetSize(chess->players_system_stats);
+    PlayerRank final_list = statsGetPlayerRankList(players_amount);
+    
+    PlayerRank current_list_pos = final_list;
+
+    MAP_CURSOR_FOREACH(cursor, chess->players_system_stats)
+    {
+        int id = (*(int*)mapCursorGetKey(&cursor));
+        
+        double current_level = calculateLevel(mapCursorGetData(&cursor));
+       
+        rankSetId(current_list_pos,id);
+        rankSetLevel(current_list_pos,current_level);
+        current_list_pos = statsGetNextPlayerRankList(current_list_pos);
+    }
+
+    return final_list;
+}
+
+static void chessUpdatePlayersSystemAndTournamentStats(ChessSystem chess,ChessTournament tournament,int first_player,int second_player,Winner winner,int play_time)
+{
+    chessCheckAddBothPlayersSystem(chess,first_player,second_player);
+    chessUpdateSystemGameResult(chess,first_player,second_player,winner,play_time);
+
+}
+
+static void chessUpdateSystemGameResult(ChessSystem chess,int first_player,int second_player,Winner winner,int play_time)
+{
+
+    int winner_id = statsGetWinnerId(first_player,second_player,winner);
+    int loser_id = statsGetLoserId(first_player,second_player,winner);
+    if(winner_id != STATS_NOT_CALCULATED)
+    {
+         chessAddWinToPlayerStats(chess,winner_id);
+         chessAddLossToPlayerStats(chess,loser_id);
+    }
+    else
+    {
+        chessAddDrawToBothPlayerStats(chess,first_player,second_player);
+    }
+    chessAddPlayTimeToBothPlayerStats(chess,first_player,second_player,play_time);
+
+}
+
+static void chessAddPlayTimeToBothPlayerStats(ChessSystem chess,int firts_player,int second_player,int play_time)
+{
+    statsAddTime(chessGetPlayerStats(chess,firts_player),play_time);
+    statsAddTime(chessGetPlayerStats(chess,second_player),play_time);
+}
+
+static void chessAddWinToPlayerStats(ChessSystem chess,int player_id)
+{
+    CHECK_NULL_VOID(chess);
+    PlayerStats player_stats = chessGetPlayerStats(chess,player_id);
+    CHECK_NULL_VOID(player_stats);
+    chessLevelsUnlink(chess,player_stats);
+    statsAddWin(player_stats);
+    chessLevelsLink(chess,player_stats);
+}
+
+static void chessAddLossToPlayerStats(ChessSystem chess,int player_id)
+{
+    CHECK_NULL_VOID(chess);
+    PlayerStats player_stats = chessGetPlayerStats(chess,player_id);
+    CHECK_NULL_VOID(player_stats);
+    chessLevelsUnlink(chess,player_stats);
+    statsAddLoss(player_stats);
+    chessLevelsLink(chess,player_stats);
+}
+
+static void chessAddDrawToBothPlayerStats(ChessSystem chess,int first_player,int second_player)
+{
+    chessAddDrawToPlayerStats(chess,first_player);
+    chessAddDrawToPlayerStats(chess,second_player);
+}
+
+static void chessAddDrawToPlayerStats(ChessSystem chess,int player_id)
+{
+    CHECK_NULL_VOID(chess);
+    PlayerStats player_stats = chessGetPlayerStats(chess,player_id);
+    CHECK_NULL_VOID(player_stats);
+    chessLevelsUnlink(chess,player_stats);
+    statsAddDraw(player_stats);
+    chessLevelsLink(chess,player_stats);
+}
+
+
+
+static PlayerStats chessGetPlayerStats(ChessSystem chess,int player_id)
+{
+    CHECK_NULL_RETURN(chess);
+    if(chess->locks != NULL)
+    {
+        return mapConstGet(chess->players_system_stats,&player_id);
+    }
+    return mapGet(chess->players_system_stats,&player_id);
+}
+
+
+
+
+
+static ChessResult chessConvertMapToChessResult(MapResult m_result)
+{
+
+    ChessResult c_result = CHESS_NULL_ARGUMENT;
+
+    switch (m_result)
+    {
+    case MAP_SUCCESS:
+        c_result = CHESS_SUCCESS;
+        break;
+    case MAP_OUT_OF_MEMORY:
+        c_result = CHESS_OUT_OF_MEMORY;
+        break;
+    case MAP_NULL_ARGUMENT:
+        c_result = CHESS_NULL_ARGUMENT;
+        break;
+    case MAP_ITEM_ALREADY_EXISTS:
+        c_result = CHESS_GAME_ALREADY_EXISTS;
+        break;
+    case MAP_ITEM_DOES_NOT_EXIST:
+        c_result = CHESS_PLAYER_NOT_EXIST;
+        break;
+    default:
+        c_result = CHESS_NULL_ARGUMENT;
+        break;
+    }
+
+    return c_result;
+
+}
+
+
+static ChessResult chessCheckTournamentNotExist(ChessSystem chess,int tournament_id)
+{
+    CHESS_CHECK_NULL_RETURN(chess);
+    ChessResult result;
+     mapContains(chess->system_tournaments,&tournament_id) ?
+      (result =  CHESS_TOURNAMENT_ALREADY_EXISTS) : (result = CHESS_SUCCESS);
+     return result;
+}
+
+
+
+
+        
+
+static ChessResult chessLoadTournamentsSnapshot(ChessSystem chess, SnapshotReader reader)
+{
+    int tournaments_amount = snapshotGetCount(reader,SNAPSHOT_INT_SIZE);
+    for(int i = 0; i < tournaments_amount; i++)
+    {
+        int tournament_id = snapshotGetInt(reader);
+        if(checkValidTournamentId(tournament_id) != CHESS_SUCCESS ||
+           chessCheckTournamentNotExist(chess,tournament_id) != CHESS_SUCCESS)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        ChessTournament tournament = tournamentLoadSnapshot(reader);
+        if(tournament == NULL)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        MapResult add_result = mapInsertOwned(chess->system_tournaments,&tournament_id,tournament);
+        if(add_result != MAP_SUCCESS)
+        {
+            freeTournament(tournament);
+            return chessConvertMapToChessResult(add_result);
+        }
+        MapKeyElement current_player_key = tournamentGetFirstPlayerKeyCopy(tournament);
+        while(current_player_key != NULL)
+        {
+            chessLinkPlayerToTournament(chess,tournament_id,*(int*)current_player_key);
+            freeIdKey(current_player_key);
+            current_player_key = tournamentGetNextPlayerKeyCopy(tournament);
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+static ChessResult chessLoadPlayersStatsSnapshot(ChessSystem chess, SnapshotReader reader)
+{
+    int players_amount = snapshotGetCount(reader,SNAPSHOT_INT_SIZE);
+    for(int i = 0; i < players_amount; i++)
+    {
+        int player_id = snapshotGetInt(reader);
+        bool created = false;
+        PlayerStats stats = mapGetOrInsert(chess->players_system_stats, (MapKeyElement)&player_id,
+                                           (initMapDataElements)initPlayerStats, &created);
+        if(stats == NULL)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        if(!created)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        statsLoadSnapshot(stats,reader);
+        chessLevelsLink(chess,stats);
+    }
+    return CHESS_SUCCESS;
+}
+
+static ChessResult chessLogOperation(ChessSystem chess, LogOperation operation, const int *values, int values_amount, const char *text)
+{
+    locksLockLog(chess->locks);
+    ChessResult result = chessLogAppend(chess,operation,values,values_amount,text);
+    if(chess->log != NULL && logCommit(chess->log) != CHESS_SUCCESS)
+    {
+        result = CHESS_SAVE_FAILURE;
+    }
+    locksUnlockLog(chess->locks);
+    return result;
+}
+
+static ChessResult chessLogAppend(ChessSystem chess, LogOperation operation, const int *values, int values_amount, const char *text)
+{
+    chess->log_sequence++;
+    if(chess->log == NULL)
+    {
+        return CHESS_SUCCESS;
+    }
+    LogRecord record = {chess->log_sequence, operation, {0}, values_amount, text};
+    memcpy(record.values,values,sizeof(int) * values_amount);
+    return logAppend(chess->log,&record);
+}
+
+static ChessResult chessApplyLogRecord(void *context, const LogRecord *record)
+{
+    ChessSystem chess = context;
+    const int *values = record->values;
+    ChessResult result = CHESS_SAVE_FAILURE;
+    switch (record->operation)
+    {
+    case LOG_ADD_TOURNAMENT:
+        if(record->values_amount == 2)
+        {
+            result = chessAddTournament(chess,values[0],values[1],record->text);
+        }
+        break;
+    case LOG_ADD_GAME:
+        if(record->values_amount == 5)
+        {
+            result = chessAddGame(chess,values[0],values[1],values[2],(Winner)values[3],values[4]);
+        }
+        break;
+    case LOG_REMOVE_PLAYER:
+        if(record->values_amount == 1)
+        {
+            result = chessRemovePlayer(chess,values[0]);
+            result = (result == CHESS_PLAYER_NOT_EXIST) ? CHESS_SUCCESS : result;
+        }
+        break;
+    case LOG_REMOVE_TOURNAMENT:
+        if(record->values_amount == 1)
+        {
+            result = chessRemoveTournament(chess,values[0]);
+        }
+        break;
+    case LOG_END_TOURNAMENT:
+        if(record->values_amount == 1)
+        {
+            result = chessEndTournament(chess,values[0]);
+        }
+        break;
+    default:
+        break;
+    }
+    if(result == CHESS_SUCCESS && chess->log_sequence != record->sequence)
+    {
+        result = CHESS_SAVE_FAILURE;
+    }
+    return result;
+}
+
+static int chessAddTournamentGames(ChessTournament tournament, const ChessGameRecord *games, const struct batch_game_t *order,
+                                   int amount, ChessResult *per_game_results, struct batch_result_t *results)
+{
+    int tournament_id = order[0].tournament_id;
+    int results_amount = 0;
+    for(int i = 0; i < amount; i++)
+    {
+        const ChessGameRecord *game = &games[order[i].index];
+        ChessResult result = checkGameVaraiables(tournament_id,game->first_player,game->second_player);
+        if(result == CHESS_SUCCESS)
+        {
+            result = (tournament == NULL) ? CHESS_TOURNAMENT_NOT_EXIST :
+                     tournamentAddGame(tournament,game->first_player,game->second_player,game->winner,game->play_time);
+        }
+        per_game_results[order[i].index] = result;
+        if(result != CHESS_SUCCESS)
+        {
+            continue;
+        }
+
+        int winner_id = statsGetWinnerId(game->first_player,game->second_player,game->winner);
+        int players[] = {game->first_player, game->second_player};
+        for(int j = 0; j < VALUES_AMOUNT(players); j++)
+        {
+            struct batch_result_t *player_result = &results[results_amount++];
+            player_result->player_id = players[j];
+            player_result->tournament_id = tournament_id;
+            player_result->wins = (winner_id == players[j]);
+            player_result->losses = (winner_id != STATS_NOT_CALCULATED && winner_id != players[j]);
+            player_result->draws = (winner_id == STATS_NOT_CALCULATED);
+            player_result->time_played = game->play_time;
+        }
+    }
+    return results_amount;
+}
+
+static void chessAddBatchGroups(void *batch, int worker_index, int workers_amount)
+{
+    (void)worker_index;
+    (void)workers_amount;
+    struct batch_t *current = batch;
+    struct batch_group_t *group = chessTakeBatchGroup(current);
+    while(group != NULL)
+    {
+        group->results_amount = chessAddTournamentGames(group->tournament,current->games,current->order + group->start,
+                                                        group->amount,current->per_game_results,
+                                                        current->results + 2 * group->start);
+        group = chessTakeBatchGroup(current);
+    }
+}
+
+static struct batch_group_t *chessTakeBatchGroup(struct batch_t *batch)
+{
+    pthread_mutex_lock(&batch->schedule_lock);
+    struct batch_group_t *group = NULL;
+    if(batch->next_group < batch->groups_amount)
+    {
+        group = batch->schedule[batch->next_group++];
+    }
+    pthread_mutex_unlock(&batch->schedule_lock);
+    return group;
+}
+
+static ChessResult chessLogBatchGames(ChessSystem chess, const ChessGameRecord *games, const struct batch_game_t *order,
+                                      int amount, const ChessResult *per_game_results)
+{
+    ChessResult result = CHESS_SUCCESS;
+    locksLockLog(chess->locks);
+    for(int i = 0; i < amount; i++)
+    {
+        const ChessGameRecord *game = &games[order[i].index];
+        if(per_game_results[order[i].index] == CHESS_SUCCESS)
+        {
+            int values[] = {game->tournament_id, game->first_player, game->second_player, game->winner, game->play_time};
+            if(chessLogAppend(chess,LOG_ADD_GAME,values,VALUES_AMOUNT(values),NULL) != CHESS_SUCCESS)
+            {
+                result = CHESS_SAVE_FAILURE;
+            }
+        }
+    }
+    if(chess->log != NULL && logCommit(chess->log) != CHESS_SUCCESS)
+    {
+        result = CHESS_SAVE_FAILURE;
+    }
+    locksUnlockLog(chess->locks);
+    return result;
+}
+
+static void chessApplyBatchResults(ChessSystem chess, struct batch_result_t *results, int amount)
+{
+    qsort(results,amount,sizeof(struct batch_result_t),compareBatchResults);
+    int start = 0;
+    while(start < amount)
+    {
+        int player_id = results[start].player_id;
+        int wins = 0, losses = 0, draws = 0, time_played = 0;
+        int end = start;
+        for(; end < amount && results[end].player_id == player_id; end++)
+        {
+            wins += results[end].wins;
+            losses += results[end].losses;
+            draws += results[end].draws;
+            time_played += results[end].time_played;
+            if(end == start || results[end].tournament_id != results[end - 1].tournament_id)
+            {
+                chessLinkPlayerToTournament(chess,results[end].tournament_id,player_id);
+            }
+        }
+
+        checkAddPlayerSystem(chess,player_id);
+        PlayerStats player_stats = chessGetPlayerStats(chess,player_id);
+        if(player_stats != NULL)
+        {
+            chessLevelsUnlink(chess,player_stats);
+            statsAddResults(player_stats,wins,losses,draws,time_played);
+            chessLevelsLink(chess,player_stats);
+        }
+        start = end;
+    }
+}
+
+static ChessResult chessImportBatch(ChessSystem chess, const ChessGameRecord *games, const long *lines, int amount,
+                                    ChessResult *results, ChessImportReport *report, ChessImportErrorFunction on_error,
+                                    void *context)
+{
+    ChessResult batch_result = chessAddGames(chess,games,amount,results);
+    if(batch_result != CHESS_SUCCESS && batch_result != CHESS_SAVE_FAILURE)
+    {
+        return batch_result;
+    }
+    for(int i = 0; i < amount; i++)
+    {
+        if(results[i] == CHESS_SUCCESS)
+        {
+            report->games_added++;
+            continue;
+        }
+        report->rejected_games++;
+        if(on_error != NULL)
+        {
+            on_error(context,lines[i],results[i]);
+        }
+    }
+    return batch_result;
+}
+
+static int compareBatchGames(const void *first_game, const void *second_game)
+{
+    const struct batch_game_t *first = first_game;
+    const struct batch_game_t *second = second_game;
+    if(first->tournament_id != second->tournament_id)
+    {
+        return (first->tournament_id > second->tournament_id) ? 1 : -1;
+    }
+    return first->index - second->index;
+}
+
+static int compareBatchGroupsBySize(const void *first_group, const void *second_group)
+{
+    const struct batch_group_t *first = *(struct batch_group_t *const *)first_group;
+    const struct batch_group_t *second = *(struct batch_group_t *const *)second_group;
+    if(first->amount != second->amount)
+    {
+        return (first->amount < second->amount) ? 1 : -1;
+    }
+    return first->start - second->start;
+}
+
+static int compareBatchResults(const void *first_result, const void *second_result)
+{
+    const struct batch_result_t *first = first_result;
+    const struct batch_result_t *second = second_result;
+    if(first->player_id != second->player_id)
+    {
+        return (first->player_id > second->player_id) ? 1 : -1;
+    }
+    return (first->tournament_id > second->tournament_id) - (first->tournament_id < second->tournament_id);
+}
+
+static ChessLocks chessGetLocks(ChessSystem chess)
+{
+    return (chess == NULL) ? NULL : chess->locks;
+}
+
+static void chessLockSystem(ChessSystem chess)
+{
+    locksLockCatalog(chessGetLocks(chess),true);
+}
+
+static void chessUnlockSystem(ChessSystem chess)
+{
+    locksUnlockCatalog(chessGetLocks(chess));
+}
+
+static ChessTournament chessLockTournament(ChessSystem chess, int tournament_id)
+{
+    locksLockCatalog(chess->locks,false);
+    ChessTournament tournament = chessGetTournament(chess,tournament_id);
+    if(tournament == NULL)
+    {
+        locksUnlockCatalog(chess->locks);
+        return NULL;
+    }
+    locksLockTournament(chess->locks,tournament);
+    return tournament;
+}
+
+static void chessUnlockTournament(ChessSystem chess, ChessTournament tournament)
+{
+    locksUnlockTournament(chess->locks,tournament);
+    locksUnlockCatalog(chess->locks);
+}
+
+static void chessLockPlayer(ChessSystem chess, int player_id)
+{
+    ChessLocks locks = chessGetLocks(chess);
+    locksLockCatalog(locks,false);
+    locksLockPlayers(locks,false);
+    locksLockStripes(locks,player_id,player_id);
+}
+
+static void chessUnlockPlayer(ChessSystem chess, int player_id)
+{
+    ChessLocks locks = chessGetLocks(chess);
+    locksUnlockStripes(locks,player_id,player_id);
+    locksUnlockPlayers(locks);
+    locksUnlockCatalog(locks);
+}
+
+static void chessLockLevels(ChessSystem chess)
+{
+    ChessLocks locks = chessGetLocks(chess);
+    locksLockCatalog(locks,false);
+    locksLockPlayers(locks,false);
+    locksLockLevels(locks);
+}
+
+static void chessUnlockLevels(ChessSystem chess)
+{
+    ChessLocks locks = chessGetLocks(chess);
+    locksUnlockLevels(locks);
+    locksUnlockPlayers(locks);
+    locksUnlockCatalog(locks);
+}
+
+static ChessTournament chessGetTournament(ChessSystem chess, int tournament_id)
+{
+    if(chess->locks != NULL)
+    {
+        return mapConstGet(chess->system_tournaments,(MapKeyElement)&tournament_id);
+    }
+    return mapGet(chess->system_tournaments,(MapKeyElement)&tournament_id);
+}
+
+static void chessAddGameToPlayers(ChessSystem chess, ChessTournament tournament, int tournament_id, int first_player,
+                                  int second_player, Winner winner, int play_time)
+{
+    ChessLocks locks = chess->locks;
+    PlayerStats first_stats = NULL, second_stats = NULL;
+    IdSet first_tournaments = NULL, second_tournaments = NULL;
+    if(locks != NULL)
+    {
+        locksLockPlayers(locks,false);
+        first_stats = mapConstGet(chess->players_system_stats,(MapKeyElement)&first_player);
+        second_stats = mapConstGet(chess->players_system_stats,(MapKeyElement)&second_player);
+        first_tournaments = mapConstGet(chess->players_tournaments,(MapKeyElement)&first_player);
+        second_tournaments = mapConstGet(chess->players_tournaments,(MapKeyElement)&second_player);
+    }
+    if(first_stats == NULL || second_stats == NULL || first_tournaments == NULL || second_tournaments == NULL)
+    {
+        locksUnlockPlayers(locks);
+        locksLockPlayers(locks,true);
+        chessUpdatePlayersSystemAndTournamentStats(chess,tournament,first_player,second_player,winner,play_time);
+        chessLinkBothPlayersToTournament(chess,tournament_id,first_player,second_player);
+        locksUnlockPlayers(locks);
+        return;
+    }
+
+    locksLockStripes(locks,first_player,second_player);
+    idSetAdd(first_tournaments,tournament_id);
+    idSetAdd(second_tournaments,tournament_id);
+    int winner_id = statsGetWinnerId(first_player,second_player,winner);
+    PlayerStats players_stats[] = {first_stats, second_stats};
+    int players[] = {first_player, second_player};
+    locksLockLevels(locks);
+    for(int i = 0; i < VALUES_AMOUNT(players); i++)
+    {
+        chessLevelsUnlink(chess,players_stats[i]);
+        statsAddResults(players_stats[i],(winner_id == players[i]),
+                        (winner_id != STATS_NOT_CALCULATED && winner_id != players[i]),
+                        (winner_id == STATS_NOT_CALCULATED),play_time);
+        chessLevelsLink(chess,players_stats[i]);
+    }
+    locksUnlockLevels(locks);
+    locksUnlockStripes(locks,first_player,second_player);
+    locksUnlockPlayers(locks);
+}
+
+static ChessResult chessAddTournamentLocked(ChessSystem chess, int tournament_id, int max_games_per_player, const char *tournament_location)
+{
+    CHESS_CHECK_NULL_RETURN(chess);
+    ChessResult check_result;
+
+    
+    check_result = checkValidTournamentId(tournament_id);
+    CHESS_CHECK_NOT_SUCCESS_RETURN(check_result);
+
+    check_result = chessCheckTournamentNotExist(chess, tournament_id);
+    CHESS_CHECK_NOT_SUCCESS_RETURN(check_result);
+
+    check_result = isValidLocation(tournament_location);
+    CHESS_CHECK_NOT_SUCCESS_RETURN(check_result);
+
+    check_result = checkValidMaxGames(max_games_per_player);
+    CHESS_CHECK_NOT_SUCCESS_RETURN(check_result);
+
+    check_result = chessAddValidTournament(chess, tournament_id,  max_games_per_player,tournament_location);
+    if(check_result == CHESS_SUCCESS)
+    {
+        int values[] = {tournament_id, max_games_per_player};
+        check_result = chessLogOperation(chess,LOG_ADD_TOURNAMENT,values,VALUES_AMOUNT(values),tournament_location);
+    }
+    return check_result;
+}
+
+static ChessResult chessAddGamesLocked(ChessSystem chess, const ChessGameRecord *games, int n, ChessResult *per_game_results)
+{
+    CHESS_CHECK_NULL_RETURN(chess);
+    if(n <= 0)
+    {
+        return CHESS_SUCCESS;
+    }
+    CHESS_CHECK_NULL_RETURN(games);
+    CHESS_CHECK_NULL_RETURN(per_game_results);
+
+    struct batch_game_t *order = malloc(sizeof(struct batch_game_t) * n);
+    struct batch_result_t *results = malloc(sizeof(struct batch_result_t) * 2 * n);
+    if(order == NULL || results == NULL)
+    {
+        free(order);
+        free(results);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    for(int i = 0; i < n; i++)
+    {
+        order[i].tournament_id = games[i].tournament_id;
+        order[i].index = i;
+    }
+    qsort(order,n,sizeof(struct batch_game_t),compareBatchGames);
+
+    int groups_amount = 1;
+    for(int i = 1; i < n; i++)
+    {
+        groups_amount += (order[i].tournament_id != order[i - 1].tournament_id);
+    }
+    struct batch_group_t *groups = malloc(sizeof(struct batch_group_t) * groups_amount);
+    struct batch_group_t **schedule = malloc(sizeof(struct batch_group_t *) * groups_amount);
+    if(groups == NULL || schedule == NULL)
+    {
+        free(order);
+        free(results);
+        free(groups);
+        free(schedule);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    int start = 0;
+    for(int i = 0; i < groups_amount; i++)
+    {
+        int end = start + 1;
+        while(end < n && order[end].tournament_id == order[start].tournament_id)
+        {
+            end++;
+        }
+        groups[i].tournament = mapGet(chess->system_tournaments,(MapKeyElement)&order[start].tournament_id);
+        groups[i].start = start;
+        groups[i].amount = end - start;
+        schedule[i] = &groups[i];
+        start = end;
+    }
+    int workers_amount = (chess->ingest_threads < groups_amount) ? chess->ingest_threads : groups_amount;
+    if(workers_amount > 1)
+    {
+        qsort(schedule,groups_amount,sizeof(struct batch_group_t *),compareBatchGroupsBySize);
+    }
+
+    struct batch_t batch = {games, order, groups, groups_amount, per_game_results, results, schedule, 0};
+    pthread_mutex_init(&batch.schedule_lock,NULL);
+    workersRun(workers_amount,chessAddBatchGroups,&batch);
+    pthread_mutex_destroy(&batch.schedule_lock);
+
+    int results_amount = 0;
+    for(int i = 0; i < groups_amount; i++)
+    {
+        memmove(results + results_amount,results + 2 * groups[i].start,
+                sizeof(struct batch_result_t) * groups[i].results_amount);
+        results_amount += groups[i].results_amount;
+    }
+    chessApplyBatchResults(chess,results,results_amount);
+    ChessResult log_result = chessLogBatchGames(chess,games,order,n,per_game_results);
+
+    free(order);
+    free(results);
+    free(groups);
+    free(schedule);
+    return log_result;
+}
+
+static ChessResult chessRemoveTournamentLocked(ChessSystem chess, int tournament_id)
+{
+    
+    if (tournament_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    if (chess == NULL || chess->system_tournaments == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    ChessTournament touranament_removed = mapGet(chess->system_tournaments,(MapKeyElement)&tournament_id);
+    CHESS_CHECK_TOURNAMENT_FOUND_RETURN(touranament_removed);
+
+    chessUpdateSystemPlayersStatsRemoveTournament(chess,touranament_removed,tournament_id);
+    ChessResult result = convertMapToChessResultTournament(mapRemove((chess->system_tournaments), (MapKeyElement)&tournament_id));
+    chessCompactSystemMaps(chess);
+    if(result == CHESS_SUCCESS)
+    {
+        result = chessLogOperation(chess,LOG_REMOVE_TOURNAMENT,&tournament_id,1,NULL);
+    }
+    return result;
+
+}
+
+static ChessResult chessRemovePlayerLocked(ChessSystem chess, int player_id)
+{
+    if (player_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    CHESS_CHECK_NULL_RETURN(chess);
+
+    ChessResult final_result = CHESS_PLAYER_NOT_EXIST;
+
+    IdSet player_tournaments = mapGet(chess->players_tournaments, (MapKeyElement)&player_id);
+    if (player_tournaments != NULL)
+    {
+        for (int i = 0; i < idSetGetSize(player_tournaments); i++)
+        {
+            int tournament_id = idSetGet(player_tournaments, i);
+            ChessTournament current_tournament = mapGet(chess->system_tournaments, (MapKeyElement)&tournament_id);
+            if (current_tournament != NULL &&
+                removePlayerFromTournament(current_tournament, player_id, chess->players_system_stats,
+                                           &chess->players_levels) == CHESS_SUCCESS)
+            {
+                final_result = CHESS_SUCCESS;
+            }
+        }
+        mapRemove(chess->players_tournaments, (MapKeyElement)&player_id);
+    }
+    chessRemovePlayerStats(chess,player_id);
+    chessCompactSystemMaps(chess);
+    ChessResult log_result = chessLogOperation(chess,LOG_REMOVE_PLAYER,&player_id,1,NULL);
+    final_result = (final_result == CHESS_SUCCESS) ? log_result : final_result;
+
+    return final_result;
+}
+
+static double chessCalculateAveragePlayTimeLocked(ChessSystem chess, int player_id, ChessResult *chess_result)
+{
+    if(chess == NULL)
+    {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return (double)STATS_NOT_CALCULATED;
+    }
+    if(player_id < 0)
+    {
+        *chess_result = CHESS_INVALID_ID;
+        return (double)STATS_NOT_CALCULATED;
+    }
+    
+    PlayerStats player_system_stats = chessGetPlayerStats(chess,player_id);
+    if(player_system_stats == NULL)
+        {
+           *chess_result = CHESS_PLAYER_NOT_EXIST;
+            return (double)STATS_NOT_CALCULATED; 
+        }
+
+    
+    int total_time = statsGetTime(player_system_stats);
+    int total_games = statsGetTotalGames(player_system_stats);
+    double average = total_time/(double)total_games;
 
         *chess_result = CHESS_SUCCESS;
         return average;
 
 }
 
-
-ChessResult chessSavePlayersLevels (ChessSystem chess, FILE* file)
+static ChessResult chessSavePlayersLevelsLocked(ChessSystem chess, FILE *file)
 {
     CHESS_CHECK_NULL_RETURN(chess);
     if(chess == NULL||file == NULL)
@@ -374,139 +2068,98 @@ ChessResult chessSavePlayersLevels (ChessSystem chess, FILE* file)
    ChessResult result = CHESS_SUCCESS;
    int length = mapGetSize(chess->players_system_stats);
    PlayerRank list = insertLevelsIds(chess);
-   insertLevelListToFile(list,length,file);
+   if(list == NULL && length > 0)
+   {
+       return CHESS_OUT_OF_MEMORY;
+   }
+   result = insertLevelListToFile(list,length,file);
    free(list);
     
     return result;
     
 }
 
-
-/* ----------------------------------------------------------------------
-
-             non header-included function's defenitions(aid functions)
-
-------------------------------------------------------------------------*/
-
-static ChessResult chessRemovePlayerStats(ChessSystem chess, int player_id)
-{
-      if(chess == NULL)
-      {
-          return CHESS_NULL_ARGUMENT;
-      }
-    
-        if(player_id <= 0)
-        {
-            return CHESS_INVALID_ID;
-        }
-
-   
-    return chessConvertMapToChessResult(mapRemove(chess->players_system_stats,&player_id));
-}
-
-static void chessDeleteSystemTournaments(ChessSystem chess)
-{
-    CHECK_NULL_VOID(chess);
-    mapDestroy(chess->system_tournaments);
-}
-
-static ChessResult chessAddValidTournament(ChessSystem chess, int tournament_id, int max_games_per_player, const char *tournament_location)
-{
-    ChessTournament new_tournament = createTournamentValid(max_games_per_player, tournament_location);
-    mapPut(chess->system_tournaments, &tournament_id, new_tournament);
-    freeTournament(new_tournament);
-    return CHESS_SUCCESS;
-}
-
-static void chessInitiateSystemVariables(ChessSystem new_chess_system)
+static ChessResult chessSavePlayersLevelsTopKLocked(ChessSystem chess, int k, FILE *file)
 {
-    new_chess_system->system_tournaments = mapCreate((copyMapDataElements)copyTournament, copyIdKey, (freeMapDataElements)freeTournament, freeIdKey, (compareMapKeyElements)(compareIdKeys));
-    new_chess_system->players_system_stats = mapCreate((copyMapDataElements)copyPlayerStats,(copyMapKeyElements)copyIdKey, 
-    (freeMapDataElements)freePlayerStats, (freeMapKeyElements)freeIdKey, (compareMapKeyElements)compareIdKeys);
-}
-
-
+    CHESS_CHECK_NULL_RETURN(chess);
+    if(file == NULL)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
 
-static void chessUpdateSystemPlayersStatsRemoveTournament(ChessSystem chess,ChessTournament tournament)
-{
-     CHECK_NULL_VOID(chess);
-     CHECK_NULL_VOID(tournament);
-   
-    MapKeyElement current_player_key = tournamentGetFirstPlayerKeyCopy(tournament);
-    PlayerStats current_player_tournament_stats = tournamentGetPlayerStatsCopy(tournament,current_player_key);
-    
-    while(current_player_tournament_stats != NULL)
+    int length = mapGetSize(chess->players_system_stats);
+    PlayerRank list = insertLevelsIds(chess);
+    if(list == NULL && length > 0)
     {
-        PlayerStats current_player_system_stats = chessGetPlayerStats(chess,*(int*)current_player_key);
-        statsSubtractStats(current_player_system_stats,current_player_tournament_stats);
-        
-        freeIdKey(current_player_key);
-        freePlayerStats(current_player_tournament_stats);
-        current_player_key = tournamentGetNextPlayerKeyCopy(tournament);
-        current_player_tournament_stats = tournamentGetPlayerStatsCopy(tournament,current_player_key);
+        return CHESS_OUT_OF_MEMORY;
     }
-    
+    ChessResult result = insertTopLevelListToFile(list,length,k,file);
+    free(list);
 
+    return result;
 }
 
-
-
-static void checkAddPlayerSystem(ChessSystem chess, int player)
+static int chessGetPlayerRankLocked(ChessSystem chess, int player_id, ChessResult *chess_result)
 {
-    if(player == PLAYER_REMOVED)
+    if(chess == NULL)
     {
-        return;
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return STATS_NOT_CALCULATED;
     }
-    if (!mapContains(chess->players_system_stats, (MapKeyElement)(&player)))
+    if(player_id <= 0)
     {
-       
-        PlayerStats new_stats = createBlankPlayerStats();
-        zeroPlayerStats(new_stats);
-        mapPut(chess->players_system_stats, (MapKeyElement)&player, (MapDataElement)new_stats);
-        free(new_stats);
-       
+        *chess_result = CHESS_INVALID_ID;
+        return STATS_NOT_CALCULATED;
+    }
+    PlayerStats player_system_stats = chessGetPlayerStats(chess,player_id);
+    if(player_system_stats == NULL)
+    {
+        *chess_result = CHESS_PLAYER_NOT_EXIST;
+        return STATS_NOT_CALCULATED;
     }
+
+    *chess_result = CHESS_SUCCESS;
+    return intrusiveMapRank(&chess->players_levels,statsGetStandingNode(player_system_stats)) + 1;
 }
 
-static int chessGetPlayerTotalGamesInSystem(ChessSystem chess_sys,int player_id)
+static int chessGetPlayerAtRankLocked(ChessSystem chess, int rank, ChessResult *chess_result)
 {
-    int current_games;
-    int total_games = 0;
-    
-    MapKeyElement current_key = mapGetFirst(chess_sys->system_tournaments);
-    ChessTournament current_tournament = mapGet(chess_sys->system_tournaments,current_key);
-    if(current_tournament == NULL)
+    if(chess == NULL)
     {
+        *chess_result = CHESS_NULL_ARGUMENT;
         return STATS_NOT_CALCULATED;
     }
-    while (current_key != NULL)
+    MapNode* player_node = intrusiveMapAtRank(&chess->players_levels,rank - 1);
+    if(player_node == NULL)
     {
-         current_games = getPlayerTotalGamesInTournament(current_tournament,player_id);
-         if(current_games != STATS_NOT_CALCULATED)
-         {
-             total_games += current_games;
-         }
-
-        freeIdKey(current_key);
-        current_key = mapGetNext(chess_sys->system_tournaments);
-        current_tournament = mapGet(chess_sys->system_tournaments,current_key);
-        
+        *chess_result = CHESS_PLAYER_NOT_EXIST;
+        return STATS_NOT_CALCULATED;
     }
-    return total_games;
+
+    *chess_result = CHESS_SUCCESS;
+    return statsGetPlayerId(statsFromStandingNode(player_node));
 }
 
-ChessResult chessSaveTournamentStatistics (ChessSystem chess, char*
-path_file)
+static ChessResult chessSaveTournamentStatisticsLocked(ChessSystem chess, char *path_file)
 {
+    CHESS_CHECK_NULL_RETURN(chess);
     FILE *fptr;
     fptr = fopen(path_file,"w");
+    if(fptr == NULL)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    ChessWriter writer = writerCreate(fptr);
+    if(writer == NULL)
+    {
+        fclose(fptr);
+        return CHESS_OUT_OF_MEMORY;
+    }
     bool is_one_tournament_ended = false;
    
-    MapKeyElement current_key = mapGetFirst(chess->system_tournaments);
-    ChessTournament current_tournament = mapGet(chess->system_tournaments,current_key);
-    
-    while(current_key != NULL)
+    MAP_CURSOR_FOREACH(cursor, chess->system_tournaments)
     {
+        ChessTournament current_tournament = mapCursorGetData(&cursor);
         if(tournamentCheckEnded(current_tournament))
         {
         !is_one_tournament_ended ? is_one_tournament_ended = true:true;
@@ -518,22 +2171,27 @@ path_file)
         char* current_location =tournamentGetLocationCopy(current_tournament);
         int current_total_players = tournamentGetPlayersAmount(current_tournament);
 
-        fprintf(fptr,"%d\n",current_winner);
-        fprintf(fptr,"%d\n",current_longest_game);
-        fprintf(fptr,"%.2f\n",current_average_game_time);
-        fprintf(fptr,"%s\n",current_location);
-        fprintf(fptr,"%d\n",current_games_amount);
-        fprintf(fptr,"%d\n",current_total_players);
+        writerPutInt(writer,current_winner);
+        writerPutChar(writer,'\n');
+        writerPutInt(writer,current_longest_game);
+        writerPutChar(writer,'\n');
+        writerPutFixed2(writer,current_average_game_time);
+        writerPutChar(writer,'\n');
+        writerPutString(writer,current_location);
+        writerPutChar(writer,'\n');
+        writerPutInt(writer,current_games_amount);
+        writerPutChar(writer,'\n');
+        writerPutInt(writer,current_total_players);
+        writerPutChar(writer,'\n');
         free(current_location);
         }
-        
-        freeIdKey(current_key);
-        current_key = mapGetNext(chess->system_tournaments);
-        current_tournament = mapGet(chess->system_tournaments,current_key);
-        
     }
 
-    fclose(fptr);
+    ChessResult write_result = writerDestroy(writer);
+    if(fclose(fptr) != 0 || write_result != CHESS_SUCCESS)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
     if(!is_one_tournament_ended)
     {
         return CHESS_NO_TOURNAMENTS_ENDED;
@@ -542,175 +2200,89 @@ path_file)
     return CHESS_SUCCESS;
 }
 
-
-
-static void chessDeleteSystemPlayersStats(ChessSystem chess)
-{
-    CHECK_NULL_VOID(chess);
-    mapDestroy(chess->players_system_stats);
-}
-
-
-
-
-static void chessCheckAddBothPlayersSystem(ChessSystem chess, int first_player, int second_player)
-{
-    checkAddPlayerSystem(chess,first_player);
-    checkAddPlayerSystem(chess,second_player);
-}
-
-
-
-
-static PlayerRank insertLevelsIds(ChessSystem chess)
+static ChessResult chessSaveSnapshotLocked(ChessSystem chess, const char *path_file)
 {
-    int players_amount = mapGetSize(chess->players_system_stats);
-    MapKeyElement current_key = mapGetFirst(chess->players_system_stats);
-    
-    PlayerStats current_stats = mapGet(chess->players_system_stats, current_key);
-    PlayerRank final_list = statsGetPlayerRankList(players_amount);
-    
-    PlayerRank current_list_pos = final_list;
-
-    while (current_key != NULL)
+    CHESS_CHECK_NULL_RETURN(chess);
+    CHESS_CHECK_NULL_RETURN(path_file);
+    int path_length = strlen(path_file);
+    char *temp_path = malloc(path_length + sizeof(SNAPSHOT_TEMP_SUFFIX));
+    if(temp_path == NULL)
     {
-        int id = (*(int*)current_key);
-        
-        double current_level = calculateLevel(current_stats);
-       
-        rankSetId(current_list_pos,id);
-        rankSetLevel(current_list_pos,current_level);
-        current_list_pos = statsGetNextPlayerRankList(current_list_pos);
-
-        freeIdKey(current_key);
-        current_key = mapGetNext(chess->players_system_stats);
-        current_stats = mapGet(chess->players_system_stats,current_key);
-        
+        return CHESS_OUT_OF_MEMORY;
     }
+    memcpy(temp_path,path_file,path_length);
+    memcpy(temp_path + path_length,SNAPSHOT_TEMP_SUFFIX,sizeof(SNAPSHOT_TEMP_SUFFIX));
 
-    return final_list;
-}
-
-static void chessUpdatePlayersSystemAndTournamentStats(ChessSystem chess,ChessTournament tournament,int first_player,int second_player,Winner winner,int play_time)
-{
-    chessCheckAddBothPlayersSystem(chess,first_player,second_player);
-    chessUpdateSystemGameResult(chess,first_player,second_player,winner,play_time);
-
-}
-
-static void chessUpdateSystemGameResult(ChessSystem chess,int first_player,int second_player,Winner winner,int play_time)
-{
-
-    int winner_id = statsGetWinnerId(first_player,second_player,winner);
-    int loser_id = statsGetLoserId(first_player,second_player,winner);
-    if(winner_id != STATS_NOT_CALCULATED)
+    FILE *fptr = fopen(temp_path,"wb");
+    if(fptr == NULL)
     {
-         chessAddWinToPlayerStats(chess,winner_id);
-         chessAddLossToPlayerStats(chess,loser_id);
+        free(temp_path);
+        return CHESS_SAVE_FAILURE;
     }
-    else
+    ChessResult result = chessWriteSnapshot(chess,fptr);
+    if(fclose(fptr) != 0 && result == CHESS_SUCCESS)
     {
-        chessAddDrawToBothPlayerStats(chess,first_player,second_player);
+        result = CHESS_SAVE_FAILURE;
     }
-    chessAddPlayTimeToBothPlayerStats(chess,winner_id,loser_id,play_time);
-
-}
-
-static void chessAddPlayTimeToBothPlayerStats(ChessSystem chess,int firts_player,int second_player,int play_time)
-{
-    statsAddTime(chessGetPlayerStats(chess,firts_player),play_time);
-    statsAddTime(chessGetPlayerStats(chess,second_player),play_time);
-}
-
-static void chessAddWinToPlayerStats(ChessSystem chess,int player_id)
-{
-    CHECK_NULL_VOID(chess);
-    PlayerStats player_stats = chessGetPlayerStats(chess,player_id);
-    CHECK_NULL_VOID(player_stats);
-    statsAddWin(player_stats);
-}
-
-static void chessAddLossToPlayerStats(ChessSystem chess,int player_id)
-{
-    CHECK_NULL_VOID(chess);
-    PlayerStats player_stats = chessGetPlayerStats(chess,player_id);
-    CHECK_NULL_VOID(player_stats);
-    statsAddLoss(player_stats);
-}
-
-static void chessAddDrawToBothPlayerStats(ChessSystem chess,int first_player,int second_player)
-{
-    chessAddDrawToPlayerStats(chess,first_player);
-    chessAddDrawToPlayerStats(chess,second_player);
+    if(result == CHESS_SUCCESS && rename(temp_path,path_file) != 0)
+    {
+        result = CHESS_SAVE_FAILURE;
+    }
+    if(result != CHESS_SUCCESS)
+    {
+        remove(temp_path);
+    }
+    free(temp_path);
+    return result;
 }
 
-static void chessAddDrawToPlayerStats(ChessSystem chess,int player_id)
+static ChessResult chessWriteSnapshot(ChessSystem chess, FILE *file)
 {
-    CHECK_NULL_VOID(chess);
-    PlayerStats player_stats = chessGetPlayerStats(chess,player_id);
-    CHECK_NULL_VOID(player_stats);
-    statsAddDraw(player_stats);
-}
-
+    SnapshotWriter writer = snapshotCreateWriter(file);
+    if(writer == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
 
+    snapshotPutInt(writer,chess->log_sequence);
+    snapshotPutInt(writer,mapGetSize(chess->system_tournaments));
+    MAP_CURSOR_FOREACH(cursor, chess->system_tournaments)
+    {
+        snapshotPutInt(writer,*(int*)mapCursorGetKey(&cursor));
+        tournamentSaveSnapshot(mapCursorGetData(&cursor),writer);
+    }
+    snapshotPutInt(writer,mapGetSize(chess->players_system_stats));
+    MAP_CURSOR_FOREACH(cursor, chess->players_system_stats)
+    {
+        snapshotPutInt(writer,*(int*)mapCursorGetKey(&cursor));
+        statsSaveSnapshot(mapCursorGetData(&cursor),writer);
+    }
 
-static PlayerStats chessGetPlayerStats(ChessSystem chess,int player_id)
-{
-    CHECK_NULL_RETURN(chess);
-    return mapGet(chess->players_system_stats,&player_id);
+    ChessResult write_result = snapshotDestroyWriter(writer);
+    if(write_result != CHESS_SUCCESS || fflush(file) != 0 || fsync(fileno(file)) != 0)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    return CHESS_SUCCESS;
 }
 
-
-
-
-
-static ChessResult chessConvertMapToChessResult(MapResult m_result)
+static ChessResult chessAttachLogLocked(ChessSystem chess, const char *path_file, ChessLogSyncPolicy policy, int batch_size)
 {
-
-    ChessResult c_result = CHESS_NULL_ARGUMENT;
-
-    switch (m_result)
+    CHESS_CHECK_NULL_RETURN(chess);
+    CHESS_CHECK_NULL_RETURN(path_file);
+    if(chess->log != NULL)
     {
-    case MAP_SUCCESS:
-        c_result = CHESS_SUCCESS;
-        break;
-    case MAP_OUT_OF_MEMORY:
-        c_result = CHESS_OUT_OF_MEMORY;
-        break;
-    case MAP_NULL_ARGUMENT:
-        c_result = CHESS_NULL_ARGUMENT;
-        break;
-    case MAP_ITEM_ALREADY_EXISTS:
-        c_result = CHESS_GAME_ALREADY_EXISTS;
-        break;
-    case MAP_ITEM_DOES_NOT_EXIST:
-        c_result = CHESS_PLAYER_NOT_EXIST;
-        break;
-    default:
-        c_result = CHESS_NULL_ARGUMENT;
-        break;
+        return CHESS_SAVE_FAILURE;
     }
-
-    return c_result;
-
+    chess->log = logOpen(path_file,policy,batch_size);
+    return (chess->log == NULL) ? CHESS_SAVE_FAILURE : CHESS_SUCCESS;
 }
 
-
-static ChessResult chessCheckTournamentNotExist(ChessSystem chess,int tournament_id)
+static ChessResult chessDetachLogLocked(ChessSystem chess)
 {
     CHESS_CHECK_NULL_RETURN(chess);
-    ChessResult result;
-     mapContains(chess->system_tournaments,&tournament_id) ?
-      (result =  CHESS_TOURNAMENT_ALREADY_EXISTS) : (result = CHESS_SUCCESS);
-     return result;
+    CHESS_CHECK_NULL_RETURN(chess->log);
+    ChessResult result = logClose(chess->log);
+    chess->log = NULL;
+    return result;
 }
-
-
-
-
-        
-
-
-
-
-
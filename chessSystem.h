@@ -33,6 +33,44 @@ typedef enum {
     DRAW
 } Winner;
 
+/*
+    Type for specifying when the records of a chess system's log are made durable(see chessAttachLog)
+*/
+typedef enum {
+    CHESS_LOG_SYNC_EVERY_COMMIT,
+    CHESS_LOG_SYNC_BATCH,
+    CHESS_LOG_SYNC_NONE
+} ChessLogSyncPolicy;
+
+/*
+    Type for a single game given to chessAddGames(the arguments chessAddGame takes)
+*/
+typedef struct {
+    int tournament_id;
+    int first_player;
+    int second_player;
+    Winner winner;
+    int play_time;
+} ChessGameRecord;
+
+/*
+    Type for the summary of a chessImportGamesFile call
+*/
+typedef struct {
+    long lines;
+    long games_added;
+    long malformed_lines;
+    long rejected_games;
+    long bytes;
+    double seconds;
+    double bytes_per_second;
+} ChessImportReport;
+
+/*
+    Type for the function chessImportGamesFile calls for every line it could not add a game from
+*/
+typedef void (*ChessImportErrorFunction)(void* context, long line_number, ChessResult result);
+
 /** Type for representing a chess system that organizes chess tournaments */
 typedef struct chess_system_t *ChessSystem;
 
@@ -69,6 +107,7 @@ void chessDestroy(ChessSystem chess);
  *     CHESS_INVALID_LOCATION - if the name is empty or doesn't start with a capital letter (A -Z)
  *                      followed by small letters (a -z) and spaces (' ').
  *     CHESS_INVALID_MAX_GAMES - if the maximum number of games allowed is not positive
+ *     CHESS_SAVE_FAILURE - if the change was made, but the system's log failed to record it(see chessAttachLog).
  *     CHESS_SUCCESS - if tournament was added successfully.
  */
 ChessResult chessAddTournament (ChessSystem chess, int tournament_id,
@@ -95,11 +134,92 @@ ChessResult chessAddTournament (ChessSystem chess, int tournament_id,
  *                                  (both were not removed).
  *     CHESS_INVALID_PLAY_TIME - if the play time is negative.
  *     CHESS_EXCEEDED_GAMES - if one of the players played the maximum number of games allowed
+ *     CHESS_SAVE_FAILURE - if the change was made, but the system's log failed to record it(see chessAttachLog).
  *     CHESS_SUCCESS - if game was added successfully.
  */
 ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player,
                          int second_player, Winner winner, int play_time);
 
+/**
+ * chessAddGames: adds a batch of matches, possibly to several tournaments. Each game gets the
+ * result chessAddGame would have returned for it, had the games been added one by one in the
+ * given order. Each tournament is looked up once for its games, and the players system
+ * statistics are updated once per player after all of the games were added. Different tournaments'
+ * games are added on several threads at once if chessSetIngestThreads was given more than 1.
+ *
+ * @param chess - chess system that contains the tournaments. Must be non-NULL.
+ * @param games - the games to add. Must be non-NULL if n is positive.
+ * @param n - amount of games.
+ * @param per_game_results - filled with each game's result(as chessAddGame's). Must be non-NULL
+ *     if n is positive.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, games or per_game_results are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed(then no game was added).
+ *     CHESS_SAVE_FAILURE - if every game was handled, but the system's log failed to record the games added.
+ *     CHESS_SUCCESS - if every game was handled(its own result is in per_game_results).
+ */
+ChessResult chessAddGames(ChessSystem chess, const ChessGameRecord* games, int n, ChessResult* per_game_results);
+
+/**
+ * chessImportGamesFile: adds the games of a text file, a game per line:
+ *     tournament_id first_player second_player winner play_time
+ * The fields are integers separated by spaces, tabs or commas. winner is 0 for FIRST_PLAYER,
+ * 1 for SECOND_PLAYER and 2 for DRAW. Empty lines are skipped. The file is mapped to memory
+ * and its games are added in batches(through chessAddGames), each with the result chessAddGame
+ * would have returned for it. A line whose game was not added does not stop the import.
+ *
+ * @param chess - chess system that contains the tournaments. Must be non-NULL.
+ * @param path_file - the games file.
+ * @param report - filled with the amount of lines read, games added, malformed lines and rejected
+ *     games, and the file's size, the time the import took and its throughput. May be NULL.
+ * @param on_error - called, if non-NULL, for every line no game was added from, with the line's number
+ *     (the first line is 1) and the game's result, or CHESS_INVALID_ID for a malformed line. Malformed
+ *     lines are reported as they are read, and rejected games once their batch was added.
+ * @param context - passed to on_error.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_SAVE_FAILURE - if the file could not be opened or mapped.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed(the games of earlier batches stay added).
+ *     CHESS_SAVE_FAILURE - also if the system's log failed to record a batch's games(the import stops after
+ *         that batch, whose games stay added).
+ *     CHESS_SUCCESS - if the whole file was read.
+ */
+ChessResult chessImportGamesFile(ChessSystem chess, const char* path_file, ChessImportReport* report,
+                                 ChessImportErrorFunction on_error, void* context);
+
+/**
+ * chessSetIngestThreads: sets the amount of threads chessAddGames(and so chessImportGamesFile) adds
+ * a batch's games on. Each tournament of a batch is added by a single thread, which adds its games in order;
+ * a thread takes the batch's next tournament whenever it is free, those with the most games first. The players
+ * system statistics are updated once all threads are done, so the system ends up exactly as if the games were
+ * added one by one. The system is 1 thread when created.
+ *
+ * @param chess - chess system to set. Must be non-NULL.
+ * @param threads - amount of threads(a value below 1 means 1).
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SUCCESS - if the amount was set.
+ */
+ChessResult chessSetIngestThreads(ChessSystem chess, int threads);
+
+/**
+ * chessEnableThreadSafety: makes a chess system safe to call from several threads at once(every function
+ * but chessDestroy, which must be called once no other call is running). Calls that work on a single
+ * tournament(chessAddGame, chessEndTournament, chessGetTournamentLeader and chessGetTournamentStandings)
+ * lock only that tournament, so calls on different tournaments run in parallel; the system stats of
+ * players already in the system are updated under locks striped by player id, and the player queries
+ * share the system. Calls that add or remove tournaments or players, add batches, or save the whole
+ * system run alone. The locks and their order are described in chessLocks.h. Must be called before
+ * the system is shared between threads, and can not be undone.
+ *
+ * @param chess - chess system to make thread safe. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed(the system stays as it was).
+ *     CHESS_SUCCESS - if the system is thread safe.
+ */
+ChessResult chessEnableThreadSafety(ChessSystem chess);
+
 /**
  * chessRemoveTournament: removes the tournament and all the games played in it from the chess system
  *                        updates all players statistics (wins, losses, draws, average play time).
@@ -111,6 +231,7 @@ ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player,
  *     CHESS_NULL_ARGUMENT - if chess is NULL.
  *     CHESS_INVALID_ID - if the tournament ID number is invalid.
  *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
+ *     CHESS_SAVE_FAILURE - if the change was made, but the system's log failed to record it(see chessAttachLog).
  *     CHESS_SUCCESS - if tournament was removed successfully.
  */
 ChessResult chessRemoveTournament (ChessSystem chess, int tournament_id);
@@ -128,6 +249,7 @@ ChessResult chessRemoveTournament (ChessSystem chess, int tournament_id);
  *     CHESS_NULL_ARGUMENT - if chess is NULL.
  *     CHESS_INVALID_ID - if the player ID number is invalid.
  *     CHESS_PLAYER_NOT_EXIST - if the player does not exist in the system.
+ *     CHESS_SAVE_FAILURE - if the change was made, but the system's log failed to record it(see chessAttachLog).
  *     CHESS_SUCCESS - if player was removed successfully.
  */
 ChessResult chessRemovePlayer(ChessSystem chess, int player_id);
@@ -152,10 +274,47 @@ ChessResult chessRemovePlayer(ChessSystem chess, int player_id);
  *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
  *     CHESS_TOURNAMENT_ENDED - if the tournament already ended
  *     CHESS_N0_GAMES - if the tournament does not have any games.
+ *     CHESS_SAVE_FAILURE - if the change was made, but the system's log failed to record it(see chessAttachLog).
  *     CHESS_SUCCESS - if tournament was ended successfully.
  */
 ChessResult chessEndTournament (ChessSystem chess, int tournament_id);
 
+/**
+ * chessGetTournamentLeader: returns the player currently leading a tournament, by the same
+ *                     criteria chessEndTournament uses for choosing the winner.
+ *                     For a tournament that ended, its winner is returned.
+ *
+ * @param chess - chess system that contains the tournament. Must be non-NULL.
+ * @param tournament_id - the tournament id. Must be positive.
+ * @param chess_result - this variable will contain the returned error code.
+ * @return
+ *     The leader's id, or -1 if an error occurred. chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_INVALID_ID - if the tournament ID number is invalid.
+ *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
+ *     CHESS_NO_GAMES - if the tournament does not have any players.
+ *     CHESS_SUCCESS - if the leader was returned successfully.
+ */
+int chessGetTournamentLeader (ChessSystem chess, int tournament_id, ChessResult* chess_result);
+
+/**
+ * chessGetTournamentStandings: fills the ids of a tournament's top players, ordered by their
+ *                     current standing(the leader first, by the criteria of chessEndTournament).
+ *                     Takes time proportional to top_k, not to the amount of players.
+ *
+ * @param chess - chess system that contains the tournament. Must be non-NULL.
+ * @param tournament_id - the tournament id. Must be positive.
+ * @param top_k - maximal amount of players to fill(the tournament may have fewer).
+ * @param player_ids - an array of at least top_k ids, to which the players are filled. Must be non-NULL.
+ * @param amount - this variable will contain the amount of ids filled. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, player_ids or amount are NULL.
+ *     CHESS_INVALID_ID - if the tournament ID number is invalid.
+ *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
+ *     CHESS_SUCCESS - if the standings were filled successfully.
+ */
+ChessResult chessGetTournamentStandings (ChessSystem chess, int tournament_id, int top_k, int* player_ids, int* amount);
+
 /**
  * chessCalculateAveragePlayTime: the function returns the average playing time for a particular player
  *
@@ -183,6 +342,53 @@ double chessCalculateAveragePlayTime (ChessSystem chess, int player_id, ChessRes
  */
 ChessResult chessSavePlayersLevels (ChessSystem chess, FILE* file);
 
+/**
+ * chessSavePlayersLevelsTopK: prints the rating of the k highest rated players in the system,
+ * in the same order and format as chessSavePlayersLevels. Takes O(n*log(k)) time for n players.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param k - amount of players to print. All of them are printed if k exceeds their amount,
+ *     and none if k is not positive.
+ * @param file - an open, writable output stream, to which the ratings are printed.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SAVE_FAILURE - if file is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - if the ratings was printed successfully.
+ */
+ChessResult chessSavePlayersLevelsTopK (ChessSystem chess, int k, FILE* file);
+
+/**
+ * chessGetPlayerRank: returns the rank of a player by level, which is the player's line number
+ * in the file printed by chessSavePlayersLevels. Takes O(log n) time for n players.
+ *
+ * @param chess - a chess system that contains the player. Must be non-NULL.
+ * @param player_id - player ID. Must be positive.
+ * @param chess_result - this variable will contain the returned error code.
+ * @return
+ *     The player's rank(1 for the highest level), or -1 if an error occurred. chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_INVALID_ID - if the player ID number is invalid.
+ *     CHESS_PLAYER_NOT_EXIST - if the player does not exist in the system.
+ *     CHESS_SUCCESS - if the rank was returned successfully.
+ */
+int chessGetPlayerRank (ChessSystem chess, int player_id, ChessResult* chess_result);
+
+/**
+ * chessGetPlayerAtRank: returns the player at a given rank by level(see chessGetPlayerRank).
+ * Takes O(log n) time for n players.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param rank - the requested rank, between 1 and the amount of players in the system.
+ * @param chess_result - this variable will contain the returned error code.
+ * @return
+ *     The player's id, or -1 if an error occurred. chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_PLAYER_NOT_EXIST - if no player is at the given rank.
+ *     CHESS_SUCCESS - if the player was returned successfully.
+ */
+int chessGetPlayerAtRank (ChessSystem chess, int rank, ChessResult* chess_result);
+
 /**
  * chessSaveTournamentStatistics: prints to the file the statistics for each tournament that ended as
  * explained in the *.pdf
@@ -197,4 +403,98 @@ ChessResult chessSavePlayersLevels (ChessSystem chess, FILE* file);
  */
 ChessResult chessSaveTournamentStatistics (ChessSystem chess, char* path_file);
 
+/**
+ * chessSaveSnapshot: saves the whole state of a chess system(its tournaments, their games and players
+ * statistics, and the players system statistics) to a binary snapshot file, which chessLoadSnapshot
+ * can later restore. The file is versioned and checksummed. It also keeps the amount of changes
+ * applied to the system so far, so chessRecover knows which log records it already holds.
+ * The snapshot is first written and synced to path_file followed by ".tmp", which then replaces
+ * path_file, so a save that fails or is cut short leaves the previous snapshot as it was.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param path_file - the file path which within it the snapshot will be saved.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving.
+ *     CHESS_SUCCESS - if the snapshot was saved successfully.
+ */
+ChessResult chessSaveSnapshot (ChessSystem chess, const char* path_file);
+
+/**
+ * chessLoadSnapshot: creates a chess system from a snapshot file saved by chessSaveSnapshot.
+ * Takes O(n log n) time for a file of n games and players: every element is inserted into its map
+ * once, and the indexes of each tournament's games by player are built by a single sort.
+ *
+ * @param path_file - the file path of the snapshot.
+ * @return
+ *     A new chess system in the state it was saved in, or NULL if path_file is NULL, the file
+ *     could not be read, is not a valid snapshot(of this version), or an allocation failed.
+ */
+ChessSystem chessLoadSnapshot (const char* path_file);
+
+/**
+ * chessAttachLog: starts recording every change made to a chess system(by chessAddTournament,
+ * chessAddGame, chessRemovePlayer, chessRemoveTournament and chessEndTournament) in an append-only
+ * log file, so chessRecover can restore the system after a crash. Records are written in batches,
+ * each followed by a single sync to disk, according to the given policy:
+ *     CHESS_LOG_SYNC_EVERY_COMMIT - every change is on disk before its function returns(the games a
+ *         chessAddGames call added are a single commit, synced once after the whole batch).
+ *     CHESS_LOG_SYNC_BATCH - changes are synced batch_size at a time(a crash loses at most the last
+ *         batch_size - 1 changes).
+ *     CHESS_LOG_SYNC_NONE - changes are synced only by chessSyncLog and chessDetachLog.
+ * A change the log failed to record(or, with CHESS_LOG_SYNC_EVERY_COMMIT, to sync) is still made, and its
+ * function returns CHESS_SAVE_FAILURE instead of CHESS_SUCCESS; so does every later change, until the log
+ * is detached. With the other policies, a sync that fails later is reported by chessSyncLog(and the changes
+ * made after it).
+ * The log file must be new, or the one the system was recovered from(or last logged to).
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param path_file - the file path of the log. Records are appended to it.
+ * @param policy - the sync policy.
+ * @param batch_size - amount of changes per sync with CHESS_LOG_SYNC_BATCH(at least 1 is used).
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_SAVE_FAILURE - if a log is already attached, or the file could not be opened.
+ *     CHESS_SUCCESS - if the log was attached successfully.
+ */
+ChessResult chessAttachLog (ChessSystem chess, const char* path_file, ChessLogSyncPolicy policy, int batch_size);
+
+/**
+ * chessSyncLog: makes every change recorded so far in a chess system's log durable.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL, or it has no log attached.
+ *     CHESS_SAVE_FAILURE - if writing the log failed at any point since it was attached.
+ *     CHESS_SUCCESS - if the log was synced successfully.
+ */
+ChessResult chessSyncLog (ChessSystem chess);
+
+/**
+ * chessDetachLog: syncs and closes a chess system's log. Changes made afterwards are not recorded.
+ * chessDestroy detaches the log as well.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL, or it has no log attached.
+ *     CHESS_SAVE_FAILURE - if writing the log failed at any point since it was attached.
+ *     CHESS_SUCCESS - if the log was detached successfully.
+ */
+ChessResult chessDetachLog (ChessSystem chess);
+
+/**
+ * chessRecover: restores a chess system from its latest snapshot and its log: the changes the log
+ * recorded after the snapshot was saved are applied on top of it. A torn record a crash left at the
+ * end of the log is cut off the file, so the log can be attached to the recovered system again.
+ *
+ * @param snapshot_path - the snapshot saved by chessSaveSnapshot, or NULL to replay the whole log
+ *     on an empty system.
+ * @param log_path - the log file. A missing file means there is nothing to replay.
+ * @return
+ *     The recovered chess system(with no log attached), or NULL if log_path is NULL, the snapshot
+ *     could not be loaded, the log is invalid or does not continue the snapshot, or an allocation failed.
+ */
+ChessSystem chessRecover (const char* snapshot_path, const char* log_path);
+
 #endif //HW1_CHESSSYSTEM_H
@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200809L
 #include "./chessTournament.h"
 #include "./chessSystem.h"
 #include "./chessReturnsMacros.h"
@@ -7,21 +8,45 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdint.h>
+#include <pthread.h>
 #define UPPER_CASE_MIN 65
 #define UPPER_CASE_MAX 90
 #define LOWER_CASE_MIN 97
 #define LOWER_CASE_MAX 122
 #define SPACE_ASCII_VALUE 32
+#define PAIR_SET_MIN_CAPACITY 16
+#define PAIR_SET_EMPTY_SLOT 0
+#define INDEX_NOT_ADDED -1
+#define GAME_ENTRY_SNAPSHOT_SIZE (5 * SNAPSHOT_INT_SIZE)
+#define STATS_ENTRY_SNAPSHOT_SIZE (6 * SNAPSHOT_INT_SIZE)
 
 /* ----------------------------------------------------------------------
 
                          Data structs defenitions
 
 ------------------------------------------------------------------------*/
+/** Struct used as an open addressing(linear probing) hash set of the player pairs who played each other
+ * @param slots - each slot holds a pair key or PAIR_SET_EMPTY_SLOT(NULL until the first pair is added)
+ * @param amount - amount of pairs in the set
+ * @param capacity - amount of slots(a power of 2, kept at least twice the amount)
+ */
+struct pair_set_t
+{
+    uint64_t *slots;
+    int amount;
+    int capacity;
+};
+
 /** Struct used for pointing at a chess-tournament's details
  * @param location - holds the location of the tournament[string](char*)
  * @param tournament_games - holds the generic data type structure of the tournament's gamees(Map)
  * @param winnerId - holds the ID of the tournament's winner(int)
+ * @param games_by_first_player - index number of tournament_games by the games' first player
+ * @param games_by_second_player - index number of tournament_games by the games' second player
+ * @param matched_pairs - the pairs of players who have a game in the tournament(both not removed)
+ * @param standings - the players' stats ordered by their current standing(the leader first)
+ * @param lock - held while the tournament is used by a thread safe chess system(see tournamentLock)
  */
 struct tournament_t
 {
@@ -33,9 +58,28 @@ struct tournament_t
     int total_game_time;
     int total_players;
     Map tournament_games;
+    int games_by_first_player;
+    int games_by_second_player;
     Map tournamnt_players_stats;
+    struct pair_set_t matched_pairs;
+    IntrusiveMap standings;
+    pthread_mutex_t lock;
 };
 
+/** Struct used as the context of removing a player from a single game(through mapUpdate)
+ * @param removed_player_id - the id of the removed player
+ * @param remained_player_id - filled with the id of the game's remaining player
+ * @param remained_player_result - filled with the remaining player's game result prior to removal
+ * @param result - filled with the removal result
+ */
+typedef struct game_removal_t
+{
+    int removed_player_id;
+    int remained_player_id;
+    PlayerPresent remained_player_result;
+    ChessResult result;
+} *GameRemoval;
+
 /* ----------------------------------------------------------------------
 
                         internal code functions headers
@@ -139,7 +183,8 @@ void tournamentCheckAddBothPlayersToStats(ChessTournament tournament, int first_
 void tournamentCheckAddPlayerStats(ChessTournament tournament, int player);
 
 /**
- * @brief Checks if a given player have reached his max agme limit
+ * @brief Checks if a given player have reached his max agme limit(the player's games amount is the total of his
+ * tournament stats, which stays equal to the amount of his games when an opponent is removed)
  * 
  * @param tournament 
  * @param player_id 
@@ -227,6 +272,155 @@ void tournamentAddBothPlayersGameTime(ChessTournament tournament, int first_play
  */
 bool checkBothPlayersDidMatch(ChessTournament tournament, int first_player, int second_player);
 
+/**
+ * @brief Links a player's stats into the tournament's standings(in the place matching the stats)
+ *
+ * @param tournament
+ * @param stats
+ */
+static void tournamentStandingsLink(ChessTournament tournament, PlayerStats stats);
+
+/**
+ * @brief Unlinks a player's stats from the tournament's standings[must be called before the stats change]
+ *
+ * @param tournament
+ * @param stats
+ */
+static void tournamentStandingsUnlink(ChessTournament tournament, PlayerStats stats);
+
+/**
+ * @brief Returns the pair set key of two players(the same for both orders of the players)
+ *
+ * @param first_player
+ * @param second_player
+ * @return uint64_t - the smaller id in the high half and the larger id in the low half
+ */
+static uint64_t pairSetKey(int first_player, int second_player);
+
+/**
+ * @brief Returns the slot holding a pair key, or the empty slot where it would be added
+ *
+ * @param pairs
+ * @param key
+ * @return int
+ */
+static int pairSetFindSlot(const struct pair_set_t *pairs, uint64_t key);
+
+/**
+ * @brief Checks if a pair key is in a pair set
+ *
+ * @param pairs
+ * @param key
+ * @return true
+ * @return false
+ */
+static bool pairSetContains(const struct pair_set_t *pairs, uint64_t key);
+
+/**
+ * @brief Makes sure a pair set has room for one more pair(rehashing into twice the slots when needed)
+ *
+ * @param pairs
+ * @return
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SUCCESS
+ */
+static ChessResult pairSetReserve(struct pair_set_t *pairs);
+
+/**
+ * @brief Adds a pair key to a pair set(pairSetReserve must have succeeded beforehand)
+ *
+ * @param pairs
+ * @param key
+ */
+static void pairSetAdd(struct pair_set_t *pairs, uint64_t key);
+
+/**
+ * @brief Removes a pair key from a pair set(if it is there), shifting back the keys probed past it
+ *
+ * @param pairs
+ * @param key
+ */
+static void pairSetRemove(struct pair_set_t *pairs, uint64_t key);
+
+/**
+ * @brief Copies a pair set into an uninitialized one
+ *
+ * @param destination
+ * @param source
+ * @return
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SUCCESS
+ */
+static ChessResult pairSetCopy(struct pair_set_t *destination, const struct pair_set_t *source);
+
+/**
+ * @brief Creates a tournament whose games map has no indexes yet(see tournamentAddGameIndexes)
+ *
+ * @param max_games_per_player
+ * @param location
+ * @return ChessTournament(NULL if allocation failed)
+ */
+static ChessTournament createTournamentWithoutIndexes(int max_games_per_player, const char *location);
+
+/**
+ * @brief Adds the indexes of the games by their first and second players to a tournament's games map.
+ * Games already in the map are indexed by a single sort per index
+ *
+ * @param tournament
+ * @return
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SUCCESS
+ */
+static ChessResult tournamentAddGameIndexes(ChessTournament tournament);
+
+/**
+ * @brief Reads the games written by tournamentSaveSnapshot into a tournament, adding the matched pairs
+ *
+ * @param tournament
+ * @param reader
+ * @return
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SAVE_FAILURE - if the snapshot holds an invalid game
+ * CHESS_SUCCESS
+ */
+static ChessResult tournamentLoadGamesSnapshot(ChessTournament tournament, SnapshotReader reader);
+
+/**
+ * @brief Reads the players stats written by tournamentSaveSnapshot into a tournament, linking them into its standings
+ *
+ * @param tournament
+ * @param reader
+ * @return
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SAVE_FAILURE - if the snapshot holds the same player twice
+ * CHESS_SUCCESS
+ */
+static ChessResult tournamentLoadStatsSnapshot(ChessTournament tournament, SnapshotReader reader);
+
+/**
+ * @brief Removes a player from a game(update function for the games map)
+ * 
+ * @param game 
+ * @param removal - GameRemoval holding the removed player and filled with the removal details
+ */
+static void gameRemovePlayerUpdate(MapDataElement game, void *removal);
+
+/**
+ * @brief Removes a player from all of its games in a given games index, and updates the remaining players stats
+ * (a game the player was removed from leaves the player's index entries, so the first entry is always the next game)
+ * 
+ * @param tournament 
+ * @param games_index - index number of tournament_games to look the player up in
+ * @param player_id 
+ * @param system_player_stats 
+ * @param system_levels - the system's levels holding the system_player_stats
+ * @return 
+ * CHESS_PLAYER_NOT_EXIST - if the player has no games in the index
+ * CHESS_SUCCESS
+ */
+static ChessResult tournamentRemovePlayerFromIndexedGames(ChessTournament tournament, int games_index, int player_id,
+                                                          Map system_player_stats, IntrusiveMap *system_levels);
+
 /* ----------------------------------------------------------------------
 
                  Header included functions defenitions
@@ -237,6 +431,16 @@ bool tournamentCheckEnded(ChessTournament tournament)
     return tournament->tournament_ended;
 }
 
+void tournamentLock(ChessTournament tournament)
+{
+    pthread_mutex_lock(&tournament->lock);
+}
+
+void tournamentUnlock(ChessTournament tournament)
+{
+    pthread_mutex_unlock(&tournament->lock);
+}
+
 ChessResult tournamentSetEnded(ChessTournament tournament)
 {
 
@@ -256,6 +460,10 @@ ChessResult tournamentSetEnded(ChessTournament tournament)
     tournament->tournament_ended = true;
 
     tournamentSetWinner(tournament);
+    /*Freezing only changes the maps' layout, and a map whose freeze failed stays
+     * fully usable, so the tournament ends either way.*/
+    (void)mapFreeze(tournament->tournament_games, sizeof(int), 0);
+    (void)mapFreeze(tournament->tournamnt_players_stats, sizeof(int), 0);
     return CHESS_SUCCESS;
 }
 
@@ -313,27 +521,13 @@ int getPlayerTotalGamesInTournament(ChessTournament tournament, int player_id)
 
 ChessTournament createTournamentValid(int max_games_per_player, const char *location)
 {
-    ChessTournament new_tournament = malloc(sizeof(struct tournament_t));
-    if (new_tournament == NULL)
+    ChessTournament new_tournament = createTournamentWithoutIndexes(max_games_per_player, location);
+    CHECK_NULL_RETURN(new_tournament);
+    if (tournamentAddGameIndexes(new_tournament) != CHESS_SUCCESS)
     {
+        freeTournament(new_tournament);
         return NULL;
     }
-
-    new_tournament->tournament_games = mapCreate((copyMapDataElements)copyGame, (copyMapKeyElements)copyIdKey,
-                                                 (freeMapDataElements)freeGame, (freeMapKeyElements)freeIdKey, (compareMapKeyElements)compareIdKeys);
-
-    new_tournament->tournamnt_players_stats = mapCreate((copyMapDataElements)copyPlayerStats, (copyMapKeyElements)copyIdKey,
-                                                        (freeMapDataElements)freePlayerStats, (freeMapKeyElements)freeIdKey, (compareMapKeyElements)compareIdKeys);
-
-    new_tournament->location = copyLocation(location);
-    new_tournament->max_games_per_player = max_games_per_player;
-    new_tournament->winnerId = WINNER_NOT_DECIDED;
-    new_tournament->tournament_ended = false;
-    new_tournament->longest_game = STATS_NOT_CALCULATED;
-    new_tournament->total_game_time = 0;
-    new_tournament->total_players = 0;
-    new_tournament->tournament_ended = false;
-
     return new_tournament;
 }
 
@@ -368,7 +562,9 @@ void freeTournament(ChessTournament tournament)
 
         mapDestroy(tournament->tournament_games);
         mapDestroy(tournament->tournamnt_players_stats);
+        free(tournament->matched_pairs.slots);
         free(tournament->location);
+        pthread_mutex_destroy(&tournament->lock);
         free(tournament);
     }
 }
@@ -381,19 +577,88 @@ ChessTournament copyTournament(ChessTournament original_tournament)
     {
         return NULL;
     }
+    pthread_mutex_init(&newTournament->lock, NULL);
     newTournament->location = copyLocation(original_tournament->location);
     newTournament->tournament_games = mapCopy(original_tournament->tournament_games);
+    newTournament->games_by_first_player = original_tournament->games_by_first_player;
+    newTournament->games_by_second_player = original_tournament->games_by_second_player;
     newTournament->winnerId = original_tournament->winnerId;
     newTournament->tournament_ended = original_tournament->tournament_ended;
     newTournament->max_games_per_player = original_tournament->max_games_per_player;
     newTournament->tournamnt_players_stats = mapCopy(original_tournament->tournamnt_players_stats);
+    intrusiveMapInit(&newTournament->standings, statsGetStandingKey, statsCompareStandings);
+    MAP_CURSOR_FOREACH(cursor, newTournament->tournamnt_players_stats)
+    {
+        tournamentStandingsLink(newTournament, mapCursorGetData(&cursor));
+    }
     newTournament->longest_game = original_tournament->longest_game;
     newTournament->total_game_time = original_tournament->total_game_time;
     newTournament->total_players = original_tournament->total_players;
+    if (pairSetCopy(&newTournament->matched_pairs, &original_tournament->matched_pairs) != CHESS_SUCCESS)
+    {
+        freeTournament(newTournament);
+        return NULL;
+    }
     return newTournament;
 }
 
-ChessResult removePlayerFromTournament(ChessTournament tournament, int player_id, Map system_player_stats)
+void tournamentSaveSnapshot(ChessTournament tournament, SnapshotWriter writer)
+{
+    snapshotPutInt(writer, tournament->max_games_per_player);
+    snapshotPutString(writer, tournament->location);
+    snapshotPutInt(writer, tournament->tournament_ended);
+    snapshotPutInt(writer, tournament->winnerId);
+    snapshotPutInt(writer, tournament->longest_game);
+    snapshotPutInt(writer, tournament->total_game_time);
+
+    snapshotPutInt(writer, mapGetSize(tournament->tournament_games));
+    MAP_CURSOR_FOREACH(cursor, tournament->tournament_games)
+    {
+        snapshotPutInt(writer, *(int *)mapCursorGetKey(&cursor));
+        gameSaveSnapshot(mapCursorGetData(&cursor), writer);
+    }
+    snapshotPutInt(writer, mapGetSize(tournament->tournamnt_players_stats));
+    MAP_CURSOR_FOREACH(cursor, tournament->tournamnt_players_stats)
+    {
+        snapshotPutInt(writer, *(int *)mapCursorGetKey(&cursor));
+        statsSaveSnapshot(mapCursorGetData(&cursor), writer);
+    }
+}
+
+ChessTournament tournamentLoadSnapshot(SnapshotReader reader)
+{
+    int max_games_per_player = snapshotGetInt(reader);
+    char *location = snapshotGetString(reader);
+    CHECK_NULL_RETURN(location);
+    ChessTournament new_tournament = createTournamentWithoutIndexes(max_games_per_player, location);
+    free(location);
+    CHECK_NULL_RETURN(new_tournament);
+
+    new_tournament->tournament_ended = (snapshotGetInt(reader) != 0);
+    new_tournament->winnerId = snapshotGetInt(reader);
+    new_tournament->longest_game = snapshotGetInt(reader);
+    new_tournament->total_game_time = snapshotGetInt(reader);
+    /*The indexes are added once all the games are in, so each is built by a single sort*/
+    if (new_tournament->location == NULL ||
+        tournamentLoadGamesSnapshot(new_tournament, reader) != CHESS_SUCCESS ||
+        tournamentAddGameIndexes(new_tournament) != CHESS_SUCCESS ||
+        tournamentLoadStatsSnapshot(new_tournament, reader) != CHESS_SUCCESS)
+    {
+        freeTournament(new_tournament);
+        return NULL;
+    }
+
+    if (new_tournament->tournament_ended)
+    {
+        /*Best effort, as in tournamentSetEnded: the maps work in any layout.*/
+        (void)mapFreeze(new_tournament->tournament_games, sizeof(int), 0);
+        (void)mapFreeze(new_tournament->tournamnt_players_stats, sizeof(int), 0);
+    }
+    return new_tournament;
+}
+
+ChessResult removePlayerFromTournament(ChessTournament tournament, int player_id, Map system_player_stats,
+                                       IntrusiveMap *system_levels)
 {
     if (player_id <= 0)
     {
@@ -402,45 +667,17 @@ ChessResult removePlayerFromTournament(ChessTournament tournament, int player_id
     CHESS_CHECK_NULL_RETURN(tournament);
     CHESS_CHECK_NULL_RETURN(system_player_stats);
 
-    ChessResult current_result = CHESS_PLAYER_NOT_EXIST;
-    ChessResult final_result = CHESS_PLAYER_NOT_EXIST;
-
     tournamentRemovePlayerStats(tournament, player_id);
 
-    MapKeyElement current_key = mapGetFirst(tournament->tournament_games);
-    ChessGame current_game = mapGet(tournament->tournament_games, current_key);
-    while (current_game != NULL)
+    ChessResult first_result = tournamentRemovePlayerFromIndexedGames(tournament, tournament->games_by_first_player,
+                                                                      player_id, system_player_stats, system_levels);
+    ChessResult second_result = tournamentRemovePlayerFromIndexedGames(tournament, tournament->games_by_second_player,
+                                                                       player_id, system_player_stats, system_levels);
+    if (first_result == CHESS_SUCCESS || second_result == CHESS_SUCCESS)
     {
-        int current_game_remained_player = STATS_NOT_CALCULATED;
-        PlayerPresent remained_player_result = STATS_NOT_CALCULATED;
-        current_result = removePlayerFromGame(current_game, player_id, &current_game_remained_player, &remained_player_result);
-
-        if (current_result == CHESS_SUCCESS)
-        {
-            final_result = CHESS_SUCCESS;
-            PlayerStats remained_player_tournament_stats = tournamentGetPlayerStats(tournament, current_game_remained_player);
-            PlayerStats remained_player_system_stats = (PlayerStats)mapGet(system_player_stats, &current_game_remained_player);
-            if (remained_player_result == PLAYER_DRAW)
-            {
-                statsAddWin(remained_player_tournament_stats);
-                statsRemoveDraw(remained_player_tournament_stats);
-                statsAddWin(remained_player_system_stats);
-                statsRemoveDraw(remained_player_system_stats);
-            }
-            else if (remained_player_result == PLAYER_LOST)
-            {
-                statsAddWin(remained_player_tournament_stats);
-                statsRemoveLoss(remained_player_tournament_stats);
-                statsAddWin(remained_player_system_stats);
-                statsRemoveLoss(remained_player_system_stats);
-            }
-        }
-        freeIdKey(current_key);
-        current_key = mapGetNext(tournament->tournament_games);
-        current_game = mapGet(tournament->tournament_games, current_key);
+        return CHESS_SUCCESS;
     }
-    freeGame(current_game);
-    return final_result;
+    return CHESS_PLAYER_NOT_EXIST;
 }
 
 ChessResult tournamentAddGame(ChessTournament tournament, int first_player, int second_player,
@@ -492,11 +729,39 @@ PlayerStats tournamentGetPlayerStatsCopy(ChessTournament tournament, MapKeyEleme
     return copyPlayerStats(original);
 }
 
+ChessResult tournamentGetPlayersStats(ChessTournament tournament, MapKeyElement* player_ids, int amount, PlayerStats* players_stats)
+{
+    CHESS_CHECK_NULL_RETURN(tournament);
+    MapResult result = mapGetMany(tournament->tournamnt_players_stats, player_ids, amount, (MapDataElement *)players_stats);
+    return convertMapToChessResultTournament(result);
+}
+
 int tournamentGetWinnerId(ChessTournament tournament)
 {
     CHECK_NULL_RETURN_NOT_CALCULATED(tournament);
     return tournament->winnerId;
 }
+
+int tournamentGetLeaderId(ChessTournament tournament)
+{
+    CHECK_NULL_RETURN_NOT_CALCULATED(tournament);
+    MapNode *leader = intrusiveMapFirst(&tournament->standings);
+    CHECK_NULL_RETURN_NOT_CALCULATED(leader);
+    return statsGetPlayerId(statsFromStandingNode(leader));
+}
+
+int tournamentGetStandings(ChessTournament tournament, int top_k, int *player_ids)
+{
+    CHECK_NULL_RETURN_NOT_CALCULATED(tournament);
+    CHECK_NULL_RETURN_NOT_CALCULATED(player_ids);
+    int filled = 0;
+    for (MapNode *current = intrusiveMapFirst(&tournament->standings); current != NULL && filled < top_k;
+         current = intrusiveMapNext(current))
+    {
+        player_ids[filled++] = statsGetPlayerId(statsFromStandingNode(current));
+    }
+    return filled;
+}
 int tournamentGetLongestGame(ChessTournament tournament)
 {
     CHECK_NULL_RETURN_NOT_CALCULATED(tournament);
@@ -587,12 +852,19 @@ static ChessResult tournamentAddValidGame(ChessTournament tournament,
                                    int first_player, int second_player, Winner winner, int play_time)
 {
 
+    if (pairSetReserve(&tournament->matched_pairs) != CHESS_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
     ChessGame new_game = gameCreate(first_player, second_player, play_time, winner);
     int key = mapGetSize(tournament->tournament_games);
     MapResult add_result = mapPut((Map)tournament->tournament_games, (MapKeyElement)&key, (MapDataElement)new_game);
     freeGame(new_game);
+    if (add_result == MAP_SUCCESS)
+    {
+        pairSetAdd(&tournament->matched_pairs, pairSetKey(first_player, second_player));
+    }
     tournament->total_game_time += play_time;
-    tournamentUpdateBothPlayersGameTime(tournament, first_player, second_player, play_time);
     return convertMapToChessResultTournament(add_result);
 }
 
@@ -636,43 +908,14 @@ static ChessResult checkBothPlayersNotPlayMaxGames(ChessTournament tournament, i
 
 static ChessResult checkPlayerNotPlayMaxGames(ChessTournament tournament, int player_id)
 {
-    if (tournament == NULL)
-    {
-        return CHESS_NULL_ARGUMENT;
-    }
-
-    if (mapGetSize(tournament->tournament_games) == 0)
-    {
-        return CHESS_SUCCESS;
-    }
-
-    int counter = 0;
-    int max_games = tournament->max_games_per_player;
-
-    MapKeyElement current_key = mapGetFirst(tournament->tournament_games);
-    ChessGame current_game = mapGet(tournament->tournament_games, current_key);
-
-    while (current_game != NULL && counter < max_games)
-    {
-
-        if (playerIsInGame(current_game, player_id) != PLAYER_NOT_IN_GAME)
-        {
-            counter++;
-        }
-        freeIdKey(current_key);
-        current_key = mapGetNext(tournament->tournament_games);
-        current_game = mapGet(tournament->tournament_games, current_key);
-    }
-    freeIdKey(current_key);
+    CHESS_CHECK_NULL_RETURN(tournament);
 
-    if (counter >= max_games)
+    PlayerStats stats = tournamentGetPlayerStats(tournament, player_id);
+    if (stats != NULL && statsGetTotalGames(stats) >= tournament->max_games_per_player)
     {
         return CHESS_EXCEEDED_GAMES;
     }
-    else
-    {
-        return CHESS_SUCCESS;
-    }
+    return CHESS_SUCCESS;
 }
 
 
@@ -680,18 +923,7 @@ static ChessResult checkPlayerNotPlayMaxGames(ChessTournament tournament, int pl
 bool checkBothPlayersDidMatch(ChessTournament tournament, int first_player, int second_player)
 {
     CHESS_CHECK_NULL_RETURN(tournament);
-    MapKeyElement current_key = mapGetFirst(tournament->tournament_games);
-
-    ChessGame current_game = mapGet(tournament->tournament_games, current_key);
-    while (current_key != NULL)
-    {
-        freeIdKey(current_key);
-        CHECK_TRUE_RETURN(checkBothPlayersInGame(current_game, first_player, second_player));
-        current_key = mapGetNext(tournament->tournament_games);
-        current_game = mapGet(tournament->tournament_games, current_key);
-    }
-
-    return false;
+    return pairSetContains(&tournament->matched_pairs, pairSetKey(first_player, second_player));
 }
 
 
@@ -700,33 +932,12 @@ static ChessResult tournamentSetWinner(ChessTournament tournament)
 {
     CHESS_CHECK_NULL_RETURN(tournament);
 
-    Map tournament_stats = tournament->tournamnt_players_stats;
-
-    MapKeyElement current_key = mapGetFirst(tournament_stats);
-    int winner_id = *(int *)(current_key);
-
-    PlayerStats current_stats = mapGet(tournament_stats, current_key);
-    PlayerStats max_stats = createBlankPlayerStats();
-    if (current_key == NULL)
+    int winner_id = tournamentGetLeaderId(tournament);
+    if (winner_id == STATS_NOT_CALCULATED)
     {
         return CHESS_PLAYER_NOT_EXIST;
     }
-    while (current_key != NULL)
-    {
-        if (statsTournamentCompareHigher(current_stats, max_stats) == FIRST_PLAYER)
-        {
-            free(max_stats);
-            max_stats = copyPlayerStats(current_stats);
-
-            winner_id = *(int *)current_key;
-        }
-        free(current_key);
-        current_key = mapGetNext(tournament_stats);
-        current_stats = mapGet(tournament_stats, current_key);
-    }
-
     tournament->winnerId = winner_id;
-    free(max_stats);
 
     return CHESS_SUCCESS;
 }
@@ -758,7 +969,9 @@ static void tournamentAddWinToPlayerStats(ChessTournament tournament, int player
     CHECK_NULL_VOID(tournament);
     PlayerStats player_stats = tournamentGetPlayerStats(tournament, player_id);
     CHECK_NULL_VOID(player_stats);
+    tournamentStandingsUnlink(tournament, player_stats);
     statsAddWin(player_stats);
+    tournamentStandingsLink(tournament, player_stats);
 }
 
 static void tournamentAddLossToPlayerStats(ChessTournament tournament, int player_id)
@@ -766,7 +979,9 @@ static void tournamentAddLossToPlayerStats(ChessTournament tournament, int playe
     CHECK_NULL_VOID(tournament);
     PlayerStats player_stats = tournamentGetPlayerStats(tournament, player_id);
     CHECK_NULL_VOID(player_stats);
+    tournamentStandingsUnlink(tournament, player_stats);
     statsAddLoss(player_stats);
+    tournamentStandingsLink(tournament, player_stats);
 }
 
 static void tournamentAddDrawToBothPlayerStats(ChessTournament tournament, int first_player, int second_player)
@@ -780,7 +995,9 @@ static void tournamentAddDrawToPlayerStats(ChessTournament tournament, int playe
     CHECK_NULL_VOID(tournament);
     PlayerStats player_stats = tournamentGetPlayerStats(tournament, player_id);
     CHECK_NULL_VOID(player_stats);
+    tournamentStandingsUnlink(tournament, player_stats);
     statsAddDraw(player_stats);
+    tournamentStandingsLink(tournament, player_stats);
 }
 
 static PlayerStats tournamentGetPlayerStats(ChessTournament tournament, int player_id)
@@ -802,13 +1019,13 @@ void tournamentCheckAddPlayerStats(ChessTournament tournament, int player)
     {
         return;
     }
-    if (!mapContains(tournament->tournamnt_players_stats, (MapKeyElement)(&player)))
+    bool created = false;
+    PlayerStats stats = mapGetOrInsert(tournament->tournamnt_players_stats, (MapKeyElement)&player,
+                                       (initMapDataElements)initPlayerStats, &created);
+    if (created)
     {
-        PlayerStats new_stats = createBlankPlayerStats();
-        zeroPlayerStats(new_stats);
-        mapPut(tournament->tournamnt_players_stats, (MapKeyElement)&player, (MapDataElement)new_stats);
         tournament->total_players++;
-        free(new_stats);
+        tournamentStandingsLink(tournament, stats);
     }
 }
 
@@ -832,14 +1049,283 @@ void tournamentAddBothPlayersGameTime(ChessTournament tournament, int first_play
 
 void tournamentRemovePlayerStats(ChessTournament tournament, int player_id)
 {
+    tournamentStandingsUnlink(tournament, tournamentGetPlayerStats(tournament, player_id));
     if (mapRemove(tournament->tournamnt_players_stats, &player_id) == MAP_SUCCESS)
     {
         tournament->total_players--;
     }
 }
 
+static void gameRemovePlayerUpdate(MapDataElement game, void *removal)
+{
+    GameRemoval game_removal = removal;
+    game_removal->result = removePlayerFromGame(game, game_removal->removed_player_id,
+                                                &game_removal->remained_player_id, &game_removal->remained_player_result);
+}
+
+static ChessResult tournamentRemovePlayerFromIndexedGames(ChessTournament tournament, int games_index, int player_id,
+                                                          Map system_player_stats, IntrusiveMap *system_levels)
+{
+    ChessResult final_result = CHESS_PLAYER_NOT_EXIST;
+    MapCursor cursor;
+    while (mapIndexCursorFirst(tournament->tournament_games, games_index, &player_id, &cursor))
+    {
+        struct game_removal_t removal = {player_id, STATS_NOT_CALCULATED, STATS_NOT_CALCULATED, CHESS_PLAYER_NOT_EXIST};
+        mapUpdate(tournament->tournament_games, mapCursorGetKey(&cursor), gameRemovePlayerUpdate, &removal);
+        if (removal.result != CHESS_SUCCESS)
+        {
+            break;
+        }
+
+        final_result = CHESS_SUCCESS;
+        if (removal.remained_player_id == PLAYER_REMOVED)
+        {
+            continue;
+        }
+        pairSetRemove(&tournament->matched_pairs, pairSetKey(player_id, removal.remained_player_id));
+        PlayerStats remained_player_tournament_stats = tournamentGetPlayerStats(tournament, removal.remained_player_id);
+        PlayerStats remained_player_system_stats = (PlayerStats)mapGet(system_player_stats, &removal.remained_player_id);
+        tournamentStandingsUnlink(tournament, remained_player_tournament_stats);
+        statsUnlinkStanding(system_levels, remained_player_system_stats);
+        if (removal.remained_player_result == PLAYER_DRAW)
+        {
+            statsAddWin(remained_player_tournament_stats);
+            statsRemoveDraw(remained_player_tournament_stats);
+            statsAddWin(remained_player_system_stats);
+            statsRemoveDraw(remained_player_system_stats);
+        }
+        else if (removal.remained_player_result == PLAYER_LOST)
+        {
+            statsAddWin(remained_player_tournament_stats);
+            statsRemoveLoss(remained_player_tournament_stats);
+            statsAddWin(remained_player_system_stats);
+            statsRemoveLoss(remained_player_system_stats);
+        }
+        tournamentStandingsLink(tournament, remained_player_tournament_stats);
+        statsLinkStanding(system_levels, remained_player_system_stats);
+    }
+    return final_result;
+}
+
+static uint64_t pairSetKey(int first_player, int second_player)
+{
+    uint64_t smaller = (uint32_t)((first_player < second_player) ? first_player : second_player);
+    uint64_t larger = (uint32_t)((first_player < second_player) ? second_player : first_player);
+    return (smaller << 32) | larger;
+}
+
+static int pairSetFindSlot(const struct pair_set_t *pairs, uint64_t key)
+{
+    uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+    int mask = pairs->capacity - 1;
+    int slot = (int)(hash >> 32) & mask;
+    while (pairs->slots[slot] != PAIR_SET_EMPTY_SLOT && pairs->slots[slot] != key)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static bool pairSetContains(const struct pair_set_t *pairs, uint64_t key)
+{
+    if (pairs->amount == 0)
+    {
+        return false;
+    }
+    return pairs->slots[pairSetFindSlot(pairs, key)] == key;
+}
 
+static ChessResult pairSetReserve(struct pair_set_t *pairs)
+{
+    if ((pairs->amount + 1) * 2 <= pairs->capacity)
+    {
+        return CHESS_SUCCESS;
+    }
 
+    int new_capacity = (pairs->capacity == 0) ? PAIR_SET_MIN_CAPACITY : pairs->capacity * 2;
+    uint64_t *new_slots = calloc(new_capacity, sizeof(uint64_t));
+    if (new_slots == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    struct pair_set_t rehashed = {new_slots, 0, new_capacity};
+    for (int i = 0; i < pairs->capacity; i++)
+    {
+        if (pairs->slots[i] != PAIR_SET_EMPTY_SLOT)
+        {
+            pairSetAdd(&rehashed, pairs->slots[i]);
+        }
+    }
+    free(pairs->slots);
+    *pairs = rehashed;
+    return CHESS_SUCCESS;
+}
 
+static void pairSetAdd(struct pair_set_t *pairs, uint64_t key)
+{
+    int slot = pairSetFindSlot(pairs, key);
+    if (pairs->slots[slot] == PAIR_SET_EMPTY_SLOT)
+    {
+        pairs->slots[slot] = key;
+        pairs->amount++;
+    }
+}
 
+static void pairSetRemove(struct pair_set_t *pairs, uint64_t key)
+{
+    if (pairs->amount == 0)
+    {
+        return;
+    }
+    int mask = pairs->capacity - 1;
+    int hole = pairSetFindSlot(pairs, key);
+    if (pairs->slots[hole] != key)
+    {
+        return;
+    }
+    pairs->slots[hole] = PAIR_SET_EMPTY_SLOT;
+    pairs->amount--;
 
+    int slot = (hole + 1) & mask;
+    while (pairs->slots[slot] != PAIR_SET_EMPTY_SLOT)
+    {
+        uint64_t moved = pairs->slots[slot];
+        pairs->slots[slot] = PAIR_SET_EMPTY_SLOT;
+        pairs->slots[pairSetFindSlot(pairs, moved)] = moved;
+        slot = (slot + 1) & mask;
+    }
+}
+
+static ChessResult pairSetCopy(struct pair_set_t *destination, const struct pair_set_t *source)
+{
+    destination->slots = NULL;
+    destination->amount = source->amount;
+    destination->capacity = source->capacity;
+    if (source->capacity == 0)
+    {
+        return CHESS_SUCCESS;
+    }
+    destination->slots = malloc(sizeof(uint64_t) * source->capacity);
+    if (destination->slots == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    memcpy(destination->slots, source->slots, sizeof(uint64_t) * source->capacity);
+    return CHESS_SUCCESS;
+}
+
+static void tournamentStandingsLink(ChessTournament tournament, PlayerStats stats)
+{
+    statsLinkStanding(&tournament->standings, stats);
+}
+
+static void tournamentStandingsUnlink(ChessTournament tournament, PlayerStats stats)
+{
+    statsUnlinkStanding(&tournament->standings, stats);
+}
+
+static ChessTournament createTournamentWithoutIndexes(int max_games_per_player, const char *location)
+{
+    ChessTournament new_tournament = malloc(sizeof(struct tournament_t));
+    if (new_tournament == NULL)
+    {
+        return NULL;
+    }
+
+    new_tournament->tournament_games = mapCreate((copyMapDataElements)copyGame, (copyMapKeyElements)copyIdKey,
+                                                 (freeMapDataElements)freeGame, (freeMapKeyElements)freeIdKey, (compareMapKeyElements)compareIdKeys);
+    new_tournament->games_by_first_player = INDEX_NOT_ADDED;
+    new_tournament->games_by_second_player = INDEX_NOT_ADDED;
+
+    new_tournament->tournamnt_players_stats = mapCreate((copyMapDataElements)copyPlayerStats, (copyMapKeyElements)copyIdKey,
+                                                        (freeMapDataElements)freePlayerStats, (freeMapKeyElements)freeIdKey, (compareMapKeyElements)compareIdKeys);
+    mapEnableFilter(new_tournament->tournamnt_players_stats, hashIdKey);
+    mapEnableFinger(new_tournament->tournament_games);
+    mapEnableFinger(new_tournament->tournamnt_players_stats);
+    intrusiveMapInit(&new_tournament->standings, statsGetStandingKey, statsCompareStandings);
+
+    new_tournament->location = copyLocation(location);
+    new_tournament->max_games_per_player = max_games_per_player;
+    new_tournament->winnerId = WINNER_NOT_DECIDED;
+    new_tournament->tournament_ended = false;
+    new_tournament->longest_game = STATS_NOT_CALCULATED;
+    new_tournament->total_game_time = 0;
+    new_tournament->total_players = 0;
+    new_tournament->tournament_ended = false;
+    new_tournament->matched_pairs.slots = NULL;
+    new_tournament->matched_pairs.amount = 0;
+    new_tournament->matched_pairs.capacity = 0;
+    pthread_mutex_init(&new_tournament->lock, NULL);
+
+    return new_tournament;
+}
+
+static ChessResult tournamentAddGameIndexes(ChessTournament tournament)
+{
+    tournament->games_by_first_player = mapAddIndex(tournament->tournament_games, gameProjectFirstPlayer, compareIdKeys);
+    tournament->games_by_second_player = mapAddIndex(tournament->tournament_games, gameProjectSecondPlayer, compareIdKeys);
+    if (tournament->games_by_first_player == INDEX_NOT_ADDED || tournament->games_by_second_player == INDEX_NOT_ADDED)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    return CHESS_SUCCESS;
+}
+
+static ChessResult tournamentLoadGamesSnapshot(ChessTournament tournament, SnapshotReader reader)
+{
+    int games_amount = snapshotGetCount(reader, GAME_ENTRY_SNAPSHOT_SIZE);
+    for (int key = 0; key < games_amount; key++)
+    {
+        if (snapshotGetInt(reader) != key)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        ChessGame game = gameLoadSnapshot(reader);
+        if (game == NULL)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        int first_player = *(int *)gameProjectFirstPlayer(NULL, game);
+        int second_player = *(int *)gameProjectSecondPlayer(NULL, game);
+        if (pairSetReserve(&tournament->matched_pairs) != CHESS_SUCCESS)
+        {
+            freeGame(game);
+            return CHESS_OUT_OF_MEMORY;
+        }
+        MapResult add_result = mapInsertOwned(tournament->tournament_games, (MapKeyElement)&key, (MapDataElement)game);
+        if (add_result != MAP_SUCCESS)
+        {
+            freeGame(game);
+            return convertMapToChessResultTournament(add_result);
+        }
+        if (first_player != PLAYER_REMOVED && second_player != PLAYER_REMOVED)
+        {
+            pairSetAdd(&tournament->matched_pairs, pairSetKey(first_player, second_player));
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+static ChessResult tournamentLoadStatsSnapshot(ChessTournament tournament, SnapshotReader reader)
+{
+    int players_amount = snapshotGetCount(reader, STATS_ENTRY_SNAPSHOT_SIZE);
+    for (int i = 0; i < players_amount; i++)
+    {
+        int player_id = snapshotGetInt(reader);
+        bool created = false;
+        PlayerStats stats = mapGetOrInsert(tournament->tournamnt_players_stats, (MapKeyElement)&player_id,
+                                           (initMapDataElements)initPlayerStats, &created);
+        if (stats == NULL)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        if (!created)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        statsLoadSnapshot(stats, reader);
+        tournament->total_players++;
+        tournamentStandingsLink(tournament, stats);
+    }
+    return CHESS_SUCCESS;
+}
@@ -26,7 +26,22 @@ typedef struct tournament_t *ChessTournament;
  bool tournamentCheckEnded(ChessTournament tournament);
 
  /**
-  * @brief Sets a tournament as 'ended'
+  * @brief Locks a tournament's own lock(waits while another thread holds it)[used by thread safe chess systems]
+  *
+  * @param tournament
+  */
+ void tournamentLock(ChessTournament tournament);
+
+ /**
+  * @brief Unlocks a tournament's own lock
+  *
+  * @param tournament
+  */
+ void tournamentUnlock(ChessTournament tournament);
+
+ /**
+  * @brief Sets a tournament as 'ended'(its games and players stats maps are frozen into flat layout, since
+  * they rarely change afterwards)
   * 
   * @param tournament 
   * @return 
@@ -105,6 +120,21 @@ int getPlayerTotalGamesInTournament(ChessTournament tournament,int player_id);
   * @param tournament 
   */
  ChessTournament copyTournament(ChessTournament original_tournament);
+/**
+ * @brief Writes a tournament's details, games and players stats to a snapshot
+ * 
+ * @param tournament 
+ * @param writer 
+ */
+void tournamentSaveSnapshot(ChessTournament tournament, SnapshotWriter writer);
+/**
+ * @brief Creates a tournament from the details written by tournamentSaveSnapshot
+ * (its games indexes, matched pairs and standings are rebuilt from the games and stats read)
+ * 
+ * @param reader 
+ * @return ChessTournament(NULL if an allocation failed or the snapshot holds no valid tournament)
+ */
+ChessTournament tournamentLoadSnapshot(SnapshotReader reader);
 
 /**
  * @brief Removes a player from a tournament(and delets his stats from the given stats map)
@@ -112,13 +142,14 @@ int getPlayerTotalGamesInTournament(ChessTournament tournament,int player_id);
  * @param tournament 
  * @param player_id 
  * @param system_player_stats 
+ * @param system_levels - the system's levels holding the system_player_stats(relinked as the remaining players' stats change)
  * @return ChessResult 
  * CHESS_PLAYER_NOT_EXIST
  * CHESS_SUCCESS
  * CHESS_INVALID_ID
  * CHESS_NULL_ARGUMENT
  */
-ChessResult removePlayerFromTournament(ChessTournament tournament, int player_id,Map system_player_stats);
+ChessResult removePlayerFromTournament(ChessTournament tournament, int player_id,Map system_player_stats,IntrusiveMap* system_levels);
 
 /**
  * @brief Adds a game to a tournament
@@ -162,6 +193,20 @@ MapKeyElement tournamentGetNextPlayerKeyCopy(ChessTournament tournament);
  */
 PlayerStats tournamentGetPlayerStatsCopy(ChessTournament tournament,MapKeyElement player_id);
 
+/**
+ * @brief Returns the stats(not copies) of a batch of players in a single lookup
+ * 
+ * @param tournament 
+ * @param player_ids - array of player id keys
+ * @param amount - length of player_ids
+ * @param players_stats - filled with each player's stats(NULL for players not in the tournament)
+ * @return 
+ * CHESS_NULL_ARGUMENT
+ * CHESS_OUT_OF_MEMORY
+ * CHESS_SUCCESS
+ */
+ChessResult tournamentGetPlayersStats(ChessTournament tournament, MapKeyElement* player_ids, int amount, PlayerStats* players_stats);
+
 /**
  * @brief Returns the tournament's winner
  * 
@@ -169,6 +214,22 @@ PlayerStats tournamentGetPlayerStatsCopy(ChessTournament tournament,MapKeyElemen
  * @return int 
  */
 int tournamentGetWinnerId(ChessTournament tournament);
+/**
+ * @brief Returns the player currently leading the tournament(by the tournament's standings, without scanning the players)
+ * 
+ * @param tournament 
+ * @return The leader's id(STATS_NOT_CALCULATED if the tournament has no players)
+ */
+int tournamentGetLeaderId(ChessTournament tournament);
+/**
+ * @brief Fills the ids of the tournament's top players by their current standing(the leader first)
+ * 
+ * @param tournament 
+ * @param top_k - maximal amount of ids to fill
+ * @param player_ids - array of at least top_k ids to fill
+ * @return Amount of ids filled(STATS_NOT_CALCULATED if a NULL argument was given)
+ */
+int tournamentGetStandings(ChessTournament tournament, int top_k, int *player_ids);
 /**
  * @brief Returns the tournament's longest game time
  * 
@@ -0,0 +1,94 @@
+#define _POSIX_C_SOURCE 200809L
+#include "./chessWorkers.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+/* ----------------------------------------------------------------------
+
+                         Data structs defenitions
+
+------------------------------------------------------------------------*/
+/** Struct used for pointing at a single worker's details
+ * @param thread
+ * @param started - whether the worker runs on its own thread
+ * @param work
+ * @param context
+ * @param worker_index
+ * @param workers_amount
+ */
+struct worker_t
+{
+    pthread_t thread;
+    bool started;
+    WorkerFunction work;
+    void *context;
+    int worker_index;
+    int workers_amount;
+};
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Runs a worker's work(the start routine of a worker thread)
+ *
+ * @param worker
+ * @return NULL
+ */
+static void *workerRun(void *worker);
+
+/* ----------------------------------------------------------------------
+
+                 Header included functions defenitions
+
+------------------------------------------------------------------------*/
+void workersRun(int workers_amount, WorkerFunction work, void *context)
+{
+    struct worker_t *workers = (workers_amount > 1) ? malloc(sizeof(struct worker_t) * workers_amount) : NULL;
+    if (workers == NULL)
+    {
+        for (int i = 0; i < workers_amount; i++)
+        {
+            work(context, i, workers_amount);
+        }
+        return;
+    }
+
+    for (int i = 0; i < workers_amount; i++)
+    {
+        workers[i].work = work;
+        workers[i].context = context;
+        workers[i].worker_index = i;
+        workers[i].workers_amount = workers_amount;
+        workers[i].started = (i > 0 && pthread_create(&workers[i].thread, NULL, workerRun, &workers[i]) == 0);
+    }
+    for (int i = 0; i < workers_amount; i++)
+    {
+        if (!workers[i].started)
+        {
+            workerRun(&workers[i]);
+        }
+    }
+    for (int i = 1; i < workers_amount; i++)
+    {
+        if (workers[i].started)
+        {
+            pthread_join(workers[i].thread, NULL);
+        }
+    }
+    free(workers);
+}
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions defenitions
+
+------------------------------------------------------------------------*/
+static void *workerRun(void *worker)
+{
+    struct worker_t *current = worker;
+    current->work(current->context, current->worker_index, current->workers_amount);
+    return NULL;
+}
@@ -0,0 +1,32 @@
+#ifndef _CHESS_WORKERS_H
+#define _CHESS_WORKERS_H
+
+/* ----------------------------------------------------------------------
+
+                         Data structs declerations
+
+------------------------------------------------------------------------*/
+/** The work a single worker thread does
+ * @param context - shared by every worker
+ * @param worker_index - the worker's number(0 to workers_amount - 1)
+ * @param workers_amount - amount of workers running the work
+ */
+typedef void (*WorkerFunction)(void *context, int worker_index, int workers_amount);
+
+/* ----------------------------------------------------------------------
+
+                         Header functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Runs a work on a given amount of workers at once, and returns once every worker is done.
+ * Worker 0 runs on the calling thread, and a worker whose thread could not be started runs on it as well
+ * (after worker 0), so every worker index always runs exactly once
+ *
+ * @param workers_amount
+ * @param work
+ * @param context
+ */
+void workersRun(int workers_amount, WorkerFunction work, void *context);
+
+#endif
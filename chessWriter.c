@@ -0,0 +1,226 @@
+#include "./chessWriter.h"
+#include "./chessReturnsMacros.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/* ----------------------------------------------------------------------
+
+                         Writer required constants
+
+------------------------------------------------------------------------*/
+#define WRITER_BUFFER_SIZE 65536
+#define WRITER_MAX_FIELD_SIZE 32
+#define WRITER_FIXED_MAX 1e9
+#define WRITER_TIE_MARGIN 1e-4
+#define DECIMAL_BASE 10
+#define CENTS_IN_UNIT 100
+/* ----------------------------------------------------------------------
+
+                         Data structs defenitions
+
+------------------------------------------------------------------------*/
+/** Struct used for pointing at a writer's details
+ * @param file - the file the buffer is written to
+ * @param used - amount of characters waiting in the buffer
+ * @param failed - whether writing to the file failed at any point
+ * @param buffer - characters waiting to be written to the file
+ */
+struct chess_writer_t
+{
+    FILE *file;
+    int used;
+    bool failed;
+    char buffer[WRITER_BUFFER_SIZE];
+};
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Writes the buffer's characters to the file and empties the buffer
+ *
+ * @param writer
+ */
+static void writerFlush(ChessWriter writer);
+
+/**
+ * @brief Makes sure the buffer has room for a given amount of characters(flushing it when needed)
+ *
+ * @param writer
+ * @param amount - at most WRITER_BUFFER_SIZE
+ */
+static void writerReserve(ChessWriter writer, int amount);
+
+/**
+ * @brief Writes an unsigned number in decimal(with at least a given amount of digits, padded with zeros)
+ *
+ * @param writer
+ * @param value
+ * @param min_digits
+ */
+static void writerPutUnsigned(ChessWriter writer, unsigned long long value, int min_digits);
+
+/**
+ * @brief Writes a real number through snprintf's "%.2f"[for the values writerPutFixed2 can't round exactly by itself]
+ *
+ * @param writer
+ * @param value
+ */
+static void writerPutFixed2Slow(ChessWriter writer, double value);
+
+/* ----------------------------------------------------------------------
+
+                 Header included functions defenitions
+
+------------------------------------------------------------------------*/
+ChessWriter writerCreate(FILE* file)
+{
+    CHECK_NULL_RETURN(file);
+    ChessWriter new_writer = malloc(sizeof(struct chess_writer_t));
+    CHECK_NULL_RETURN(new_writer);
+    new_writer->file = file;
+    new_writer->used = 0;
+    new_writer->failed = false;
+    return new_writer;
+}
+
+void writerPutChar(ChessWriter writer, char character)
+{
+    writerReserve(writer, 1);
+    writer->buffer[writer->used++] = character;
+}
+
+void writerPutString(ChessWriter writer, const char* str)
+{
+    writerPutBytes(writer, str, strlen(str));
+}
+
+void writerPutBytes(ChessWriter writer, const void* bytes, int amount)
+{
+    const char *current = bytes;
+    while (amount > 0)
+    {
+        if (writer->used == WRITER_BUFFER_SIZE)
+        {
+            writerFlush(writer);
+        }
+        int chunk = WRITER_BUFFER_SIZE - writer->used;
+        if (chunk > amount)
+        {
+            chunk = amount;
+        }
+        memcpy(writer->buffer + writer->used, current, chunk);
+        writer->used += chunk;
+        current += chunk;
+        amount -= chunk;
+    }
+}
+
+void writerPutInt(ChessWriter writer, int value)
+{
+    unsigned long long magnitude = (value < 0) ? -(long long)value : (long long)value;
+    if (value < 0)
+    {
+        writerPutChar(writer, '-');
+    }
+    writerPutUnsigned(writer, magnitude, 1);
+}
+
+void writerPutFixed2(ChessWriter writer, double value)
+{
+    if (isnan(value) || fabs(value) >= WRITER_FIXED_MAX)
+    {
+        writerPutFixed2Slow(writer, value);
+        return;
+    }
+
+    double scaled = fabs(value) * CENTS_IN_UNIT;
+    double whole = floor(scaled);
+    double fraction = scaled - whole;
+    if (fabs(fraction - 0.5) < WRITER_TIE_MARGIN)
+    {
+        writerPutFixed2Slow(writer, value);
+        return;
+    }
+
+    unsigned long long cents = (unsigned long long)whole + (fraction > 0.5);
+    if (signbit(value))
+    {
+        writerPutChar(writer, '-');
+    }
+    writerPutUnsigned(writer, cents / CENTS_IN_UNIT, 1);
+    writerPutChar(writer, '.');
+    writerPutUnsigned(writer, cents % CENTS_IN_UNIT, 2);
+}
+
+ChessResult writerDestroy(ChessWriter writer)
+{
+    CHESS_CHECK_NULL_RETURN(writer);
+    writerFlush(writer);
+    bool failed = writer->failed;
+    free(writer);
+    return failed ? CHESS_SAVE_FAILURE : CHESS_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------
+
+                Non header included functions defenitions
+
+------------------------------------------------------------------------*/
+static void writerFlush(ChessWriter writer)
+{
+    if (writer->used > 0 && fwrite(writer->buffer, 1, writer->used, writer->file) != (size_t)writer->used)
+    {
+        writer->failed = true;
+    }
+    writer->used = 0;
+}
+
+static void writerReserve(ChessWriter writer, int amount)
+{
+    if (WRITER_BUFFER_SIZE - writer->used < amount)
+    {
+        writerFlush(writer);
+    }
+}
+
+static void writerPutUnsigned(ChessWriter writer, unsigned long long value, int min_digits)
+{
+    char digits[WRITER_MAX_FIELD_SIZE];
+    int amount = 0;
+    do
+    {
+        digits[amount++] = (char)('0' + value % DECIMAL_BASE);
+        value /= DECIMAL_BASE;
+    } while (value > 0 || amount < min_digits);
+
+    writerReserve(writer, amount);
+    while (amount > 0)
+    {
+        writer->buffer[writer->used++] = digits[--amount];
+    }
+}
+
+static void writerPutFixed2Slow(ChessWriter writer, double value)
+{
+    char formatted[WRITER_MAX_FIELD_SIZE];
+    int length = snprintf(formatted, sizeof(formatted), "%.2f", value);
+    if (length < 0 || length >= (int)sizeof(formatted))
+    {
+        char *large = malloc(length + 1);
+        if (length < 0 || large == NULL)
+        {
+            writer->failed = true;
+            free(large);
+            return;
+        }
+        snprintf(large, length + 1, "%.2f", value);
+        writerPutString(writer, large);
+        free(large);
+        return;
+    }
+    writerPutString(writer, formatted);
+}
@@ -0,0 +1,79 @@
+#ifndef _CHESS_WRITER_H
+#define _CHESS_WRITER_H
+#include <stdio.h>
+#include "./chessSystem.h"
+
+/* ----------------------------------------------------------------------
+
+                         Data structs declerations
+
+------------------------------------------------------------------------*/
+/** Buffered writer used by the report exports: values are formatted by hand into a large buffer,
+ * which is written to the file in big blocks(instead of an fprintf call per value) */
+typedef struct chess_writer_t *ChessWriter;
+
+/* ----------------------------------------------------------------------
+
+                         Header functions declerations
+
+------------------------------------------------------------------------*/
+/**
+ * @brief Creates a writer over a given open, writable file
+ *
+ * @param file
+ * @return ChessWriter(NULL if file is NULL or the allocation failed)
+ */
+ChessWriter writerCreate(FILE* file);
+
+/**
+ * @brief Writes a single character
+ *
+ * @param writer
+ * @param character
+ */
+void writerPutChar(ChessWriter writer, char character);
+
+/**
+ * @brief Writes a string(without its terminating null character)
+ *
+ * @param writer
+ * @param str
+ */
+void writerPutString(ChessWriter writer, const char* str);
+
+/**
+ * @brief Writes a given amount of raw bytes
+ *
+ * @param writer
+ * @param bytes
+ * @param amount
+ */
+void writerPutBytes(ChessWriter writer, const void* bytes, int amount);
+
+/**
+ * @brief Writes an integer in decimal[same output as printf's "%d"]
+ *
+ * @param writer
+ * @param value
+ */
+void writerPutInt(ChessWriter writer, int value);
+
+/**
+ * @brief Writes a real number with exactly two decimal digits[same output as printf's "%.2f"]
+ *
+ * @param writer
+ * @param value
+ */
+void writerPutFixed2(ChessWriter writer, double value);
+
+/**
+ * @brief Writes whatever is left in the writer's buffer to its file, and frees the writer(the file stays open)
+ *
+ * @param writer
+ * @return
+ * CHESS_SAVE_FAILURE - if writing to the file failed at any point
+ * CHESS_SUCCESS
+ */
+ChessResult writerDestroy(ChessWriter writer);
+
+#endif
@@ -2,9 +2,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <string.h>
 #define NOT_FOUND -1
 #define EMPTY_NO_SIZE -1
 #define EMPTY_ARGUMENT -2
+#define FILTER_BLOCK_WORDS 8
+#define FILTER_BLOCK_BITS 512
+#define FILTER_BIT_INDEX_WIDTH 9
+#define FILTER_HASHES 6
+#define FILTER_BITS_PER_KEY 16
+#define FILTER_ACTIVATION_SIZE 8
+#define FILTER_MIN_CAPACITY 32
+#define INDEX_NOT_CREATED -1
+#define TREE_LAYOUT_MIN_SIZE 16
+#define TREE_LAYOUT_DROP_SIZE 8
+#define FLAT_MIN_CAPACITY 8
+#define PROBE_SEARCH_FACTOR 4
 
 /* ----------------------------------------------------------------------
 
@@ -23,9 +36,89 @@ typedef struct entry_t
     struct entry_t* next;
 } *Entry;
 
+/** Struct used for holding a blocked Bloom filter over the map's keys. Every key sets
+ * FILTER_HASHES bits inside a single 512 bit(one cache line) block, so a lookup touches one block only.
+ * Bits can not be cleared, so removals are counted and the filter is rebuilt once too many accumulated.
+ * @param hashFnc - pointer for a function used for hashing keys
+ * @param blocks - the filter's bit array(NULL until the map reaches FILTER_ACTIVATION_SIZE entries)
+ * @param block_count - amount of 512 bit blocks in the bit array
+ * @param capacity - amount of keys the bit array was sized for
+ * @param stale - amount of keys removed since the bit array was last built
+ * @param stats - lookup counters reported by mapGetFilterStats
+ */
+typedef struct filter_t
+{
+    hashMapKeyElements hashFnc;
+    uint64_t* blocks;
+    int block_count;
+    int capacity;
+    int stale;
+    MapFilterStats stats;
+} *Filter;
+
+/** Struct used as a single record of a secondary index, pointing at one of the map's entries
+ * @param node - the record's node in the index's tree
+ * @param projected - the entry's key in the index(as returned by the index's projection function)
+ * @param entry - the entry the record stands for
+ */
+typedef struct index_record_t
+{
+    MapNode node;
+    MapKeyElement projected;
+    struct entry_t* entry;
+} *IndexRecord;
+
+/** Struct used for holding a secondary index: a balanced tree of records ordered by the projected key and then by the map's key
+ * @param projectFnc - pointer for a function used for projecting an element onto its index key
+ * @param compareFnc - pointer for a function used for comparing projected keys
+ * @param records - the tree of records(one per element of the map). Records are ordered by indexCompareRecord,
+ * so the tree is searched and linked by the index functions, and only rebalanced and unlinked by the intrusive map ones
+ * @param spare - a record allocated by indexReserve for the next insertion(NULL if none)
+ */
+typedef struct index_t
+{
+    projectMapElements projectFnc;
+    compareMapKeyElements compareFnc;
+    IntrusiveMap records;
+    struct index_record_t* spare;
+} *Index;
+
+/** Struct used as a node of the search tree kept over the entries of large maps
+ * @param node - the intrusive tree node
+ * @param entry - the entry the node stands for
+ */
+typedef struct search_node_t
+{
+    MapNode node;
+    Entry entry;
+} *SearchNode;
+
 /** Struct used for holding the map data structure
  * @param first - pointer for the "head" of the linked list(first entry by order of keys)
  * @param iterator - pointer for an entry. used for external iteration of the map 
+ * @param size - amount of entries in the map
+ * @param filter - optional lookup filter(NULL if mapEnableFilter was not called)
+ * @param slab - contiguous array of the entries relocated by the last mapRebuild(NULL if never rebuilt)
+ * @param key_slab - contiguous memory of the keys relocated by the last mapRebuild(NULL if keys were not relocated)
+ * @param data_slab - contiguous memory of the data relocated by the last mapRebuild(NULL if data was not relocated)
+ * @param slab_capacity - amount of entries slab was allocated for
+ * @param key_slab_capacity - amount of keys key_slab was allocated for
+ * @param data_slab_capacity - amount of data elements data_slab was allocated for
+ * @param key_size - size of a key relocated into key_slab
+ * @param data_size - size of a data element relocated into data_slab
+ * @param indexes - array of the secondary indexes registered by mapAddIndex
+ * @param index_count - amount of secondary indexes
+ * @param search_tree - balanced tree over the entries, used for searching while tree_layout is set
+ * @param tree_layout - whether the map is large enough to be searched through search_tree.
+ * Small maps are searched by scanning the list, which is faster than a tree below TREE_LAYOUT_MIN_SIZE entries
+ * and costs no memory besides the entries
+ * @param flat_keys - in flat layout, the keys of all entries in order(flat_keys[i] is flat_entries[i]->key)
+ * @param flat_entries - in flat layout, all the entries in order
+ * @param flat_size - amount of entries in the flat arrays
+ * @param flat_capacity - amount of entries the flat arrays have room for
+ * @param flat_layout - whether the map is searched through the flat arrays(set by mapCreateFlat and mapFreeze)
+ * @param finger_enabled - whether the map remembers its last accessed entry(set by mapEnableFinger)
+ * @param finger - the last entry found, inserted or iterated over(NULL if none or if the finger is disabled)
  * @param copyDataFnc - pointer for a function used for allocating a copy of a given data
  * @param copyKeyFnc - pointer for a function used for allocating a copy of a given key
  * @param copyDataFnc - pointer for a function used for releasing memory for a given data adress
@@ -36,6 +129,27 @@ struct Map_t
 {
     Entry first;
     Entry iterator;
+    int size;
+    Filter filter;
+    Entry slab;
+    char* key_slab;
+    char* data_slab;
+    int slab_capacity;
+    int key_slab_capacity;
+    int data_slab_capacity;
+    size_t key_size;
+    size_t data_size;
+    Index indexes;
+    int index_count;
+    IntrusiveMap search_tree;
+    bool tree_layout;
+    MapKeyElement* flat_keys;
+    Entry* flat_entries;
+    int flat_size;
+    int flat_capacity;
+    bool flat_layout;
+    bool finger_enabled;
+    Entry finger;
     copyMapDataElements copyDataFnc;
     copyMapKeyElements copyKeyFnc;
     freeMapDataElements freeDataFnc;
@@ -185,8 +299,545 @@ MapResult mapRemoveAid(Map map,Entry back,PutResult putRes);
   /**
 * mapCopyList: Makes a copy of the first given map's list of entries and places it in the second
 * @param originalMap - Map pointer of the data structure which will have it's list copied
-* @param destinationMap - Map pointer of the data structure which will store the copy of the list*/
-void mapCopyList(Map originalMap, Map destinationMap);
+* @param destinationMap - Map pointer of the data structure which will store the copy of the list
+* @return
+* MAP_OUT_OF_MEMORY if an element could not be copied, MAP_SUCCESS otherwise*/
+MapResult mapCopyList(Map originalMap, Map destinationMap);
+
+/**
+* mapFindEntry: Searches the map for a key without modifying anything
+*
+* @param map - Map pointer of the data structure to search in
+* @param key - Key pointer to look for
+* @return
+* The entry holding an equal key, or NULL if the key is not in the map
+*/
+static Entry mapFindEntry(ConstMap map, MapKeyElement key);
+
+/**
+* mapInsertNewEntry: Inserts a key which is not in the map after a given entry, with its data
+* either given(stored as is) or created by an init function. Nothing is created or taken if an
+* allocation fails
+*
+* @param map - Map pointer
+* @param keyElement - Key to be copied for the new entry
+* @param dataElement - Data to be stored as is, or NULL to create it by initDataElement
+* @param initDataElement - Creates the data of the key(used only if dataElement is NULL)
+* @param back - The entry the new one follows in the list(as filled by mapFindPosition)
+* @return
+* The new entry, or NULL if an allocation failed(the map and dataElement are unchanged in that case)
+*/
+static Entry mapInsertNewEntry(Map map, MapKeyElement keyElement, MapDataElement dataElement,
+                               initMapDataElements initDataElement, Entry back);
+
+/**
+* mapFindPosition: Searches the map's list for a key in a single pass
+*
+* @param map - Map pointer of the data structure to search in
+* @param key - Key pointer to look for
+* @param back - Filled with the last entry whose key is smaller than the given key
+* (NULL if there is no such entry), which is where a missing key should be linked after
+* @return
+* The entry holding an equal key, or NULL if the key is not in the map
+*/
+static Entry mapFindPosition(ConstMap map, MapKeyElement key, Entry* back);
+
+/**
+* mapFingerSearch: Searches for a key starting from the map's finger(the last accessed entry) when possible,
+* and moves the finger to the entry found. A key equal to the finger's costs a single compare, the key
+* following it a second one, and in list layout any greater key is scanned for from the finger onward.
+* Other keys are searched for by mapFindPosition.
+*
+* @param map - Map pointer
+* @param key - Key to look for
+* @param back - Filled as by mapFindPosition, or NULL if the caller does not need it
+* @return
+* The entry holding an equal key, NULL if there is none
+*/
+static Entry mapFingerSearch(Map map, MapKeyElement key, Entry* back);
+
+/**
+* slabHolds: Checks if an element lies inside a slab allocated by mapRebuild
+*
+* @param slab - Start of the slab(may be NULL)
+* @param element_size - Size of a single element of the slab
+* @param capacity - Amount of elements the slab holds
+* @param element - Pointer to be checked
+* @return
+* true - the element is one of the slab's elements(and must not be freed on its own)
+* false - otherwise
+*/
+static bool slabHolds(const void* slab, size_t element_size, int capacity, const void* element);
+
+/**
+* freeEntryKey: Releases a key element of the map, unless it was relocated into the map's key slab
+*
+* @param map - Map pointer of the data structure
+* @param key - Key pointer to be released
+*/
+static void freeEntryKey(Map map, MapKeyElement key);
+
+/**
+* freeEntryData: Releases a data element of the map, unless it was relocated into the map's data slab
+*
+* @param map - Map pointer of the data structure
+* @param data - Data pointer to be released
+*/
+static void freeEntryData(Map map, MapDataElement data);
+
+/**
+* freeSlabs: Releases the slabs allocated by mapRebuild. Must only be called once no entry lives in them.
+*
+* @param map - Map pointer of the data structure
+*/
+static void freeSlabs(Map map);
+
+/**
+* indexCompareRecord: Compares a (projected key, key) pair with an index record
+*
+* @param map - Map pointer holding the key compare function
+* @param index - Index holding the projected key compare function
+* @param projected - Projected key
+* @param key - Key of the map, or NULL to compare by the projected key only
+* @param record - Record to compare with
+* @return
+* Matches the compare function criterias presented at map.h
+*/
+static int indexCompareRecord(ConstMap map, const struct index_t* index, MapKeyElement projected,
+                              MapKeyElement key, const struct index_record_t* record);
+
+/**
+* indexLowerBound: Returns the first record not smaller than a (projected key, key) pair
+*
+* @param map - Map pointer holding the key compare function
+* @param index - Index to search in
+* @param projected - Projected key
+* @param key - Key of the map, or NULL to find the first record of the projected key
+* @return
+* The record, or NULL if all records are smaller
+*/
+static IndexRecord indexLowerBound(ConstMap map, const struct index_t* index, MapKeyElement projected, MapKeyElement key);
+
+/**
+* indexFindRecord: Returns the record of an entry in an index
+*
+* @param map - Map pointer holding the key compare function
+* @param index - Index to search in
+* @param entry - The entry(with the key and data it was indexed with)
+* @return
+* The entry's record, or NULL if it has none
+*/
+static IndexRecord indexFindRecord(ConstMap map, const struct index_t* index, Entry entry);
+
+/**
+* indexLink: Links a record(with its projected key and entry set) into an index's tree, in O(log n)
+*
+* @param map - Map pointer holding the key compare function
+* @param index - Index to link into
+* @param record - Unlinked record
+*/
+static void indexLink(ConstMap map, Index index, IndexRecord record);
+
+/**
+* indexReserve: Makes sure every index of the map has a spare record for one more element
+*
+* @param map - Map pointer holding the indexes
+* @return
+* MAP_OUT_OF_MEMORY - an allocation failed
+* MAP_SUCCESS - otherwise
+*/
+static MapResult indexReserve(Map map);
+
+/**
+* indexInsertElement: Adds records of an entry to all of the map's indexes(using their spare records).
+* indexReserve must have succeeded beforehand.
+*
+* @param map - Map pointer holding the indexes
+* @param entry - The entry, holding its stored key and data
+*/
+static void indexInsertElement(Map map, Entry entry);
+
+/**
+* indexRemoveElement: Removes the records of an entry from all of the map's indexes. A removed record
+* becomes its index's spare record if it has none, so a following indexInsertElement needs no indexReserve
+*
+* @param map - Map pointer holding the indexes
+* @param entry - The entry, holding the key and data it was indexed with
+*/
+static void indexRemoveElement(Map map, Entry entry);
+
+/**
+* indexRelocateElement: Points the records of an entry at the entry's new memory
+* (the new key and data are equal to the old ones, so the records keep their order)
+*
+* @param map - Map pointer holding the indexes
+* @param old_entry - The entry before relocation(its key and data are still allocated)
+* @param new_entry - The entry after relocation
+*/
+static void indexRelocateElement(Map map, Entry old_entry, Entry new_entry);
+
+/**
+* indexBuild: Fills an empty index with records of all the map's entries: the records are sorted
+* once and linked into a balanced tree, instead of being inserted one by one
+*
+* @param map - Map pointer
+* @param index - Empty index of the map
+* @return
+* MAP_OUT_OF_MEMORY - an allocation failed(the index stays empty)
+* MAP_SUCCESS - otherwise
+*/
+static MapResult indexBuild(Map map, Index index);
+
+/**
+* indexSortRecords: Sorts a list of records linked through their nodes' right pointers
+* (merge sort by indexCompareRecord)
+*
+* @param map - Map pointer holding the key compare function
+* @param index - Index holding the projected key compare function
+* @param list - First node of the list
+* @param amount - Amount of nodes in the list
+* @return
+* First node of the sorted list
+*/
+static MapNode* indexSortRecords(ConstMap map, const struct index_t* index, MapNode* list, int amount);
+
+/**
+* indexDropRecords: Frees all the records of an index, and its spare record
+*
+* @param index - Index pointer
+*/
+static void indexDropRecords(Index index);
+
+/**
+* sortKeysOrder: Sorts an array of positions by the keys they point at(stable merge sort using
+* the map's compare function). NULL keys are ordered last.
+*
+* @param map - Map pointer holding the compare function
+* @param keys - Array of keys the positions refer to
+* @param order - Array of positions(indexes into keys) to be sorted
+* @param buffer - Work array of the same length as order
+* @param amount - Length of order
+*/
+static void sortKeysOrder(Map map, MapKeyElement* keys, int* order, int* buffer, int amount);
+
+/**
+* probesBySearch: Checks if a batch of keys is cheaper to resolve by a search per key than by a sweep
+* over the whole map, which is when the map is searchable in logarithmic time and
+* PROBE_SEARCH_FACTOR * amount * log2(size) is still below its size
+*
+* @param map - Map pointer
+* @param amount - Amount of keys in the batch
+* @return
+* true - each key should be searched for on its own
+* false - the batch should be resolved in a single sweep
+*/
+static bool probesBySearch(ConstMap map, int amount);
+
+/**
+* compareProbeKeys: Compares two keys of a batch, ordering NULL keys after all others
+*
+* @param map - Map pointer holding the compare function
+* @param first - Key pointer
+* @param second - Key pointer
+* @return
+* Matches the compare function criterias presented at map.h
+*/
+static int compareProbeKeys(Map map, MapKeyElement first, MapKeyElement second);
+
+/**
+* searchNodeKey: Returns the key of the entry a search tree node stands for(key accessor of search_tree)
+*
+* @param node - Node of the map's search tree
+*/
+static MapKeyElement searchNodeKey(const MapNode* node);
+
+/**
+* searchTreeLink: Adds a node for a new entry to the map's search tree
+*
+* @param map - Map pointer in tree layout
+* @param node - Unused search node allocated for the entry
+* @param entry - The new entry(already linked into the list)
+*/
+static void searchTreeLink(Map map, SearchNode node, Entry entry);
+
+/**
+* searchTreeUnlink: Removes and frees the search tree node of an entry(does nothing in list layout)
+*
+* @param map - Map pointer
+* @param entry - The entry being removed
+*/
+static void searchTreeUnlink(Map map, Entry entry);
+
+/**
+* searchTreeBuild: Switches the map to tree layout by building a search tree over all the entries.
+* If an allocation fails the map stays in list layout.
+*
+* @param map - Map pointer in list layout
+*/
+static void searchTreeBuild(Map map);
+
+/**
+* searchTreeDrop: Switches the map to list layout, freeing the search tree(does nothing in list layout)
+*
+* @param map - Map pointer
+*/
+static void searchTreeDrop(Map map);
+
+/**
+* searchTreeAdapt: Switches the map's layout after its size had changed. The map switches to tree layout
+* above TREE_LAYOUT_MIN_SIZE entries and back to list layout at TREE_LAYOUT_DROP_SIZE entries, so a map
+* whose size moves around one threshold does not rebuild its tree on every change.
+*
+* @param map - Map pointer
+*/
+static void searchTreeAdapt(Map map);
+
+/**
+* searchTreeReserve: Allocates the search tree node for an entry about to be added(if the map is in tree layout)
+*
+* @param map - Map pointer
+* @param node - Filled with the new node, or NULL in list layout
+* @return
+* MAP_OUT_OF_MEMORY - an allocation failed
+* MAP_SUCCESS - otherwise
+*/
+static MapResult searchTreeReserve(Map map, SearchNode* node);
+
+/**
+* flatEnable: Switches the map to flat layout(drops its search tree and fills the flat arrays)
+*
+* @param map - Map pointer
+* @return
+* MAP_OUT_OF_MEMORY - an allocation failed(the map is unchanged)
+* MAP_SUCCESS - otherwise
+*/
+static MapResult flatEnable(Map map);
+
+/**
+* flatFill: Refills the flat arrays from the list(after the entries had been relocated)
+*
+* @param map - Map pointer in flat layout, with flat_capacity of at least the map's size
+*/
+static void flatFill(Map map);
+
+/**
+* flatLowerBound: Returns the position of the first key in the flat arrays not smaller than a given key.
+* The search halves the range without branching on the comparison, so its loop runs the same
+* number of times for every key.
+*
+* @param map - Map pointer in flat layout
+* @param key - Key to look for
+* @return
+* Position in the flat arrays(flat_size if all the keys are smaller)
+*/
+static int flatLowerBound(ConstMap map, MapKeyElement key);
+
+/**
+* flatReserve: Makes sure the flat arrays have room for one more entry(if the map is in flat layout)
+*
+* @param map - Map pointer
+* @return
+* MAP_OUT_OF_MEMORY - an allocation failed
+* MAP_SUCCESS - otherwise
+*/
+static MapResult flatReserve(Map map);
+
+/**
+* flatInsert: Adds a new entry to the flat arrays(does nothing out of flat layout). flatReserve must have succeeded beforehand.
+*
+* @param map - Map pointer
+* @param entry - The new entry
+*/
+static void flatInsert(Map map, Entry entry);
+
+/**
+* flatRemove: Removes an entry from the flat arrays(does nothing out of flat layout)
+*
+* @param map - Map pointer
+* @param entry - The entry being removed
+*/
+static void flatRemove(Map map, Entry entry);
+
+/**
+* nodeHeight: Returns the height of an intrusive map's subtree(0 for an empty subtree)
+*
+* @param node - Root of the subtree, may be NULL
+*/
+static int nodeHeight(const MapNode* node);
+
+/**
+* nodeCount: Returns the amount of nodes in an intrusive map's subtree(0 for an empty subtree)
+*
+* @param node - Root of the subtree, may be NULL
+*/
+static int nodeCount(const MapNode* node);
+
+/**
+* nodeUpdate: Recalculates a node's height and count from its children
+*
+* @param node - The node to update
+*/
+static void nodeUpdate(MapNode* node);
+
+/**
+* nodeReplaceChild: Makes a parent(or the tree's root) point at a new child instead of an old one.
+* The new child's parent pointer is updated too.
+*
+* @param map - Intrusive map pointer holding the root
+* @param parent - Parent of the old child, NULL if the old child is the root
+* @param old_child - The child to be replaced
+* @param new_child - The child replacing it, may be NULL
+*/
+static void nodeReplaceChild(IntrusiveMap* map, MapNode* parent, MapNode* old_child, MapNode* new_child);
+
+/**
+* nodeRotateLeft: Rotates a subtree left(its right child becomes its root)
+*
+* @param map - Intrusive map pointer holding the root
+* @param node - Root of the subtree, must have a right child
+* @return
+* The new root of the subtree
+*/
+static MapNode* nodeRotateLeft(IntrusiveMap* map, MapNode* node);
+
+/**
+* nodeRotateRight: Rotates a subtree right(its left child becomes its root)
+*
+* @param map - Intrusive map pointer holding the root
+* @param node - Root of the subtree, must have a left child
+* @return
+* The new root of the subtree
+*/
+static MapNode* nodeRotateRight(IntrusiveMap* map, MapNode* node);
+
+/**
+* nodeRebalance: Updates heights and counts from a node up to the root, rotating where the tree is unbalanced
+*
+* @param map - Intrusive map pointer holding the root
+* @param node - The lowest node whose subtree had changed, may be NULL
+*/
+static void nodeRebalance(IntrusiveMap* map, MapNode* node);
+
+/**
+* nodeTreeToVine: Turns a tree into a list of its nodes in key order, linked through their right pointers
+* (by right rotations, in linear time and without allocations)
+*
+* @param root - Root of the tree, may be NULL
+* @return
+* The first node of the list(NULL for an empty tree)
+*/
+static MapNode* nodeTreeToVine(MapNode* root);
+
+/**
+* nodeVineToTree: Builds a balanced tree, in linear time, of the first nodes of a list linked through
+* their right pointers(as made by nodeTreeToVine), keeping their order
+*
+* @param vine - The list's first node, advanced past the nodes used
+* @param amount - Amount of nodes to build the tree of
+* @param parent - Parent of the tree's root
+* @return
+* The tree's root(NULL if amount is 0)
+*/
+static MapNode* nodeVineToTree(MapNode** vine, int amount, MapNode* parent);
+
+/**
+* nodeTreeCompact: Drops the nodes of a tree that dropNode chooses and rebalances the rest,
+* in a single linear pass(used for removing many elements at once)
+*
+* @param tree - The tree to compact
+* @param dropNode - Function freeing a node and returning true if it is to be dropped,
+* returning false and leaving the node alone otherwise
+*/
+static void nodeTreeCompact(IntrusiveMap* tree, bool (*dropNode)(MapNode*));
+
+/**
+* indexRecordDrop: Frees an index record whose entry was removed by mapRemoveIf(its key is NULL)
+*
+* @param node - Node of the record
+* @return
+* true if the record was freed, false otherwise
+*/
+static bool indexRecordDrop(MapNode* node);
+
+/**
+* searchNodeDrop: Frees a search tree node whose entry was removed by mapRemoveIf(its key is NULL)
+*
+* @param node - Node of the search tree
+* @return
+* true if the node was freed, false otherwise
+*/
+static bool searchNodeDrop(MapNode* node);
+
+/**
+* filterKeyHash: Mixes the user's hash of a key into the 64 bits used for choosing a block and bits
+*
+* @param filter - Filter holding the user's hash function
+* @param key - Key to be hashed
+* @return
+* The mixed 64 bit hash of the key
+*/
+static uint64_t filterKeyHash(const struct filter_t* filter, MapKeyElement key);
+
+/**
+* filterAddKey: Sets the bits of a key in the filter's bit array
+*
+* @param filter - Filter with an allocated bit array
+* @param key - Key to be added
+*/
+static void filterAddKey(Filter filter, MapKeyElement key);
+
+/**
+* filterBuild: (Re)allocates the filter's bit array for the map's current size and adds all of its keys.
+* On allocation failure the bit array is dropped, which only disables the filter.
+*
+* @param map - Map pointer holding the filter
+*/
+static void filterBuild(Map map);
+
+/**
+* filterExcludes: Checks a key against a filter without touching its counters
+*
+* @param filter - Filter to be checked(may be NULL)
+* @param key - Key looked up
+* @return
+* true - the filter is active and the key is definitely not in the map
+* false - the key may be in the map(or the filter is not active)
+*/
+static bool filterExcludes(const struct filter_t* filter, MapKeyElement key);
+
+/**
+* filterRejects: Checks a key against the map's filter and updates the lookup counters
+*
+* @param map - Map pointer holding the filter
+* @param key - Key looked up
+* @return
+* true - the key is definitely not in the map
+* false - the key may be in the map(or the filter is not active)
+*/
+static bool filterRejects(Map map, MapKeyElement key);
+
+/**
+* filterCountFalsePositive: Records a lookup which passed the filter although the key was absent
+*
+* @param map - Map pointer holding the filter
+*/
+static void filterCountFalsePositive(Map map);
+
+/**
+* filterUpdateOnPut: Adds a newly inserted key to the filter, building or growing the bit array when needed
+*
+* @param map - Map pointer holding the filter
+* @param key - Key inserted
+*/
+static void filterUpdateOnPut(Map map, MapKeyElement key);
+
+/**
+* filterUpdateOnRemove: Accounts for removed keys, rebuilding the bit array when too many removals accumulated
+*
+* @param map - Map pointer holding the filter
+* @param removed - Amount of keys removed
+*/
+static void filterUpdateOnRemove(Map map, int removed);
 
   
 
@@ -215,6 +866,27 @@ Map mapCreate(copyMapDataElements copyDataFnc,
 
     newMap->iterator = NULL;
     newMap->first =NULL;
+    newMap->size = 0;
+    newMap->filter = NULL;
+    newMap->slab = NULL;
+    newMap->key_slab = NULL;
+    newMap->data_slab = NULL;
+    newMap->slab_capacity = 0;
+    newMap->key_slab_capacity = 0;
+    newMap->data_slab_capacity = 0;
+    newMap->key_size = 0;
+    newMap->data_size = 0;
+    newMap->indexes = NULL;
+    newMap->index_count = 0;
+    intrusiveMapInit(&newMap->search_tree,searchNodeKey,compareKeyFnc);
+    newMap->tree_layout = false;
+    newMap->flat_keys = NULL;
+    newMap->flat_entries = NULL;
+    newMap->flat_size = 0;
+    newMap->flat_capacity = 0;
+    newMap->flat_layout = false;
+    newMap->finger_enabled = false;
+    newMap->finger = NULL;
     newMap->copyDataFnc = copyDataFnc;
     newMap->copyKeyFnc = copyKeyFnc;
     newMap->freeDataFnc = freeDataFnc;
@@ -231,6 +903,16 @@ void mapDestroy(Map map)
     {
         return;
     }
+    for (int i = 0; i < map->index_count; i++)
+    {
+        indexDropRecords(&map->indexes[i]);
+    }
+    free(map->indexes);
+    map->index_count = 0;
+    searchTreeDrop(map);
+    free(map->flat_keys);
+    free(map->flat_entries);
+    map->flat_layout = false;
 
    Entry current = map->first;
     
@@ -242,6 +924,12 @@ void mapDestroy(Map map)
         destroyEntry(map,toDelete);
     }
 
+    if (map->filter != NULL)
+    {
+        free(map->filter->blocks);
+        free(map->filter);
+    }
+    freeSlabs(map);
     free(map);
 }
 
@@ -253,8 +941,36 @@ Map mapCopy(Map originalMap)
     }
     Map newMap = mapCreate(originalMap->copyDataFnc, originalMap->copyKeyFnc,
     originalMap->freeDataFnc, originalMap->freeKeyFnc,originalMap->compareKeyFnc);
+    if(newMap == NULL)
+    {
+        return NULL;
+    }
+    if(originalMap->filter != NULL && mapEnableFilter(newMap,originalMap->filter->hashFnc) != MAP_SUCCESS)
+    {
+        mapDestroy(newMap);
+        return NULL;
+    }
+    for(int i = 0; i < originalMap->index_count; i++)
+    {
+        if(mapAddIndex(newMap,originalMap->indexes[i].projectFnc,
+                       originalMap->indexes[i].compareFnc) == INDEX_NOT_CREATED)
+        {
+            mapDestroy(newMap);
+            return NULL;
+        }
+    }
+    if(originalMap->flat_layout && flatEnable(newMap) != MAP_SUCCESS)
+    {
+        mapDestroy(newMap);
+        return NULL;
+    }
+    newMap->finger_enabled = originalMap->finger_enabled;
 
-    mapCopyList(originalMap,newMap);
+    if(mapCopyList(originalMap,newMap) != MAP_SUCCESS)
+    {
+        mapDestroy(newMap);
+        return NULL;
+    }
     return newMap;
 }
 
@@ -265,17 +981,7 @@ int mapGetSize(Map map)
         return EMPTY_NO_SIZE;
     }
 
-    Entry current = map->first;
-   
-
-    int counter = 0; 
-    while(current != NULL)
-    {  
-        counter ++;
-        current = current->next;
-    }
-    return counter;
-    
+    return map->size;
 }
 
 bool mapContains(Map map, MapKeyElement key)
@@ -284,18 +990,17 @@ bool mapContains(Map map, MapKeyElement key)
     {
         return false;
     }
+    if(filterRejects(map,key))
+    {
+        return false;
+    }
 
-   Entry current = map->first;
-    while(current != NULL)
+    if(mapFingerSearch(map,key,NULL) != NULL)
     {
-        if(map->compareKeyFnc(current->key,key) == 0)
-        {
-            return true;
-        }
-        current = current->next;
-        
+        return true;
     }
 
+    filterCountFalsePositive(map);
     return false;
 }
 
@@ -309,43 +1014,29 @@ MapResult mapPut(Map map, MapKeyElement inputKey, MapDataElement data)
     PutResult putRes = PUT_INITIALIZED;
 
    Entry back = NULL;
-   Entry front = NULL;
-    if(map->first == NULL)
+   Entry front = mapFingerSearch(map,inputKey,&back);
+    if(front != NULL)
+    {
+        putRes = PUT_REPLACE;
+    }
+    else if(map->first == NULL)
     {
         putRes = PUT_EMPTY;
     }
-
-    else if(map->compareKeyFnc(map->first->key,inputKey) > 0)
+    else if(back == NULL)
     {
        putRes = PUT_FIRST;
     }
-    else 
+    else if(back->next == NULL)
     {
-         back = NULL;
-         front = map->first;
-        while(front != NULL && putRes == PUT_INITIALIZED)
-        {
-            if(map->compareKeyFnc(front->key,inputKey) == 0)
-            {
-                putRes = PUT_REPLACE;
-            }
-            else if(map->compareKeyFnc(front->key,inputKey) > 0)
-            {
-                putRes = PUT_MID;
-            }
-            else
-            {
-                back = front;
-                front = front->next;
-            }
-        }
-        if(putRes == PUT_INITIALIZED)
-        {
-            putRes = PUT_LAST;
-        }
-
+        putRes = PUT_LAST;
     }
-  
+    else
+    {
+        putRes = PUT_MID;
+        front = back->next;
+    }
+
     return mapPutAid(map,inputKey,data,back,front,putRes);
 }
 
@@ -356,18 +1047,18 @@ MapDataElement mapGet(Map map, MapKeyElement inputKey)
     {
         return NULL;
     }
+    if(filterRejects(map,inputKey))
+    {
+        return NULL;
+    }
 
-   Entry current = map->first;
-    while(current!= NULL)
+   Entry current = mapFingerSearch(map,inputKey,NULL);
+    if(current != NULL)
     {
-       
-        if(map->compareKeyFnc(current->key,inputKey) == 0)
-        {
-            return current->data;
-        }
-        current = current->next;
+        return current->data;
     }
 
+    filterCountFalsePositive(map);
     return NULL;
 }
 
@@ -378,49 +1069,26 @@ MapResult mapRemove(Map map, MapKeyElement inputKey)
     {
         return MAP_NULL_ARGUMENT;
     }
+    if(filterRejects(map,inputKey))
+    {
+        return MAP_ITEM_DOES_NOT_EXIST;
+    }
     PutResult putRes = PUT_INITIALIZED;
 
    Entry back = NULL;
-   Entry front = map->first;
-    while(front != NULL && putRes == PUT_INITIALIZED)
-    {   
-        if(map->compareKeyFnc(front->key,inputKey) == 0)
-            {
-    
-                front = front->next;
-                if(front != NULL)
-                {
-                    if(back != NULL)
-                    {
-                        putRes = PUT_MID;
-                    }
-                    else
-                    {
-                        putRes = PUT_FIRST; 
-                    }
-                }
-                else
-                {
-                    if(back != NULL)
-                    {
-                        putRes = PUT_LAST;
-                    }
-                    else
-                    {
-                        putRes = PUT_EMPTY;
-                    }
-                }
-               
-
-            }
-
-        if(putRes == PUT_INITIALIZED)
+   Entry found = mapFingerSearch(map,inputKey,&back);
+    if(found != NULL)
+    {
+        if(found->next != NULL)
         {
-            back = front;
-            front = front->next;
+            putRes = (back != NULL) ? PUT_MID : PUT_FIRST;
         }
-    }  
-        
+        else
+        {
+            putRes = (back != NULL) ? PUT_LAST : PUT_EMPTY;
+        }
+    }
+
   return mapRemoveAid(map,back,putRes);
 }
 
@@ -431,6 +1099,10 @@ MapKeyElement mapGetFirst(Map map)
         return NULL;
     }
     map->iterator = map->first;
+    if(map->finger_enabled)
+    {
+        map->finger = map->iterator;
+    }
 
     return map->copyKeyFnc(map->first->key);
 }
@@ -443,7 +1115,11 @@ MapKeyElement mapGetNext(Map map)
     }
 
     map->iterator = map->iterator->next;
-    
+    if(map->finger_enabled)
+    {
+        map->finger = map->iterator;
+    }
+
     return map->copyKeyFnc(map->iterator->key);
 }
 
@@ -454,245 +1130,2044 @@ MapResult mapClear(Map map)
         return MAP_NULL_ARGUMENT;
     }
 
+    for(int i = 0; i < map->index_count; i++)
+    {
+        indexDropRecords(&map->indexes[i]);
+    }
+    searchTreeDrop(map);
+    map->flat_size = 0;
    Entry current = map->first;
     while(current != NULL)
     {
        Entry toDelete = current;
         current = current->next;
-        mapRemove(map,toDelete->key);
+        destroyEntry(map,toDelete);
+    }
+    map->first = NULL;
+    map->iterator = NULL;
+    map->size = 0;
+    freeSlabs(map);
+    if(map->filter != NULL)
+    {
+        free(map->filter->blocks);
+        map->filter->blocks = NULL;
+        map->filter->block_count = 0;
+        map->filter->capacity = 0;
+        map->filter->stale = 0;
     }
 
     return MAP_SUCCESS;
 }
 
-/* ----------------------------------------------------------------------
-
-             non header-included function's defenitions(aid functions)
-
-------------------------------------------------------------------------*/
-
-void destroyEntry(Map map,Entry entry)
+MapDataElement mapGetOrInsert(Map map, MapKeyElement keyElement,
+                              initMapDataElements initDataElement, bool* created)
 {
-    if(entry != NULL)
-        {
-            map->freeDataFnc(entry->data);
-            map->freeKeyFnc(entry->key);
-            free(entry);
-        }
-}
-
+    if(map == NULL || keyElement == NULL || initDataElement == NULL)
+    {
+        return NULL;
+    }
 
-MapResult mapRemoveAid(Map map,Entry back,PutResult putRes)
-{
-    MapResult result;
-     switch (putRes)
-   {
-   case PUT_EMPTY:
-        result =  removeFirstEntry(map);
-       break;
-   case PUT_FIRST:
-       result =  removeFirstEntry(map);
-       break;
-    case PUT_MID:
-        result =  removeMidLastEntry(map,back);
-       break;
-    case PUT_LAST:
-        result = removeMidLastEntry(map,back);
-       break;
-    case PUT_INITIALIZED:
-        result = MAP_ITEM_DOES_NOT_EXIST;
-        break;
-    default:
-        result = MAP_NULL_ARGUMENT;
-      break;
-   }
+    Entry back = NULL;
+    Entry found = mapFingerSearch(map,keyElement,&back);
+    if(created != NULL)
+    {
+        *created = (found == NULL);
+    }
+    if(found != NULL)
+    {
+        return found->data;
+    }
 
-    return result;
+    Entry newEntry = mapInsertNewEntry(map,keyElement,NULL,initDataElement,back);
+    return (newEntry == NULL) ? NULL : newEntry->data;
 }
 
-MapResult removeFirstEntry(Map map)
+MapResult mapInsertOwned(Map map, MapKeyElement keyElement, MapDataElement dataElement)
 {
-    if(map == NULL|| map->first == NULL)
+    if(map == NULL || keyElement == NULL || dataElement == NULL)
     {
         return MAP_NULL_ARGUMENT;
     }
-   Entry newFirst = map->first->next;
-    destroyEntry(map,map->first);
-    map->first = newFirst;
-    return MAP_SUCCESS; 
-}
 
-MapResult removeMidLastEntry(Map map,Entry back)
-{
-    if(map == NULL|| back == NULL||back->next == NULL)
+    Entry back = NULL;
+    if(mapFingerSearch(map,keyElement,&back) != NULL)
     {
-        return MAP_NULL_ARGUMENT;
+        return MAP_ITEM_ALREADY_EXISTS;
     }
-
-   Entry victim = back->next;
-   Entry front = victim->next;
-
-    destroyEntry(map,victim);
-    back->next = front;
-
-    return MAP_SUCCESS; 
+    return (mapInsertNewEntry(map,keyElement,dataElement,NULL,back) == NULL) ? MAP_OUT_OF_MEMORY : MAP_SUCCESS;
 }
 
-MapResult mapPutAid(Map map, MapKeyElement key,MapDataElement data,Entry back,Entry front,PutResult putRes)
+MapResult mapUpdate(Map map, MapKeyElement keyElement,
+                    updateMapDataElements updateDataElement, void* context)
 {
-    MapResult result;
-     switch (putRes)
-   {
-   case PUT_EMPTY:
-        result = putNewEntryEmptyMap(map,key,data);
-       break;
-   case PUT_FIRST:
-        result = putNewEntryFirst(map,key,data);
-       break;
-   case PUT_REPLACE:
-        result = replaceEntryData(map,front,key,data); 
-       break;
-    case PUT_MID:
-        result = putNewEntryMid(map,key,data,back,front);
-       break;
-    case PUT_LAST:
-        result = putNewEntryMid(map,key,data,back,NULL);
-       break;
-    default :
+    if(map == NULL || keyElement == NULL || updateDataElement == NULL)
+    {
         return MAP_NULL_ARGUMENT;
+    }
 
-       
-   }
-
-   return result;
-}
-
- MapResult putNewEntryEmptyMap(Map map, MapKeyElement key,MapDataElement data)
-{
-    if(map == NULL || key == NULL || data == NULL)
+    if(filterRejects(map,keyElement))
     {
-        return MAP_NULL_ARGUMENT;
+        return MAP_ITEM_DOES_NOT_EXIST;
     }
-   Entry newEntry = createNewEntry(map,key,data);
-    if(newEntry == NULL)
+    Entry found = mapFingerSearch(map,keyElement,NULL);
+    if(found == NULL)
     {
-        return MAP_OUT_OF_MEMORY;
+        filterCountFalsePositive(map);
+        return MAP_ITEM_DOES_NOT_EXIST;
     }
-
-    map->first = newEntry;
+    indexRemoveElement(map,found);
+    updateDataElement(found->data,context);
+    indexInsertElement(map,found);
     return MAP_SUCCESS;
 }
 
-MapResult putNewEntryFirst(Map map, MapKeyElement key,MapDataElement data)
+MapResult mapGetMany(Map map, MapKeyElement* keyElements, int amount,
+                     MapDataElement* dataElements)
 {
-    if(map == NULL || key == NULL || data == NULL)
+    if(map == NULL || keyElements == NULL || dataElements == NULL)
     {
         return MAP_NULL_ARGUMENT;
     }
-   Entry newEntry = createNewEntry(map,key,data);
-    if(newEntry == NULL)
+    if(amount < 0)
     {
-        return MAP_OUT_OF_MEMORY;
+        return MAP_ERROR;
     }
-
-   Entry current = map->first;
-    map->first = newEntry;
-    newEntry->next = current;
-    return MAP_SUCCESS;
-}
-
-MapResult replaceEntryData(Map map,Entry entry, MapKeyElement key,MapDataElement data)
-{
-    if(map == NULL || key == NULL || data == NULL||entry == NULL)
+    if(amount == 0)
     {
-        return MAP_NULL_ARGUMENT;
+        return MAP_SUCCESS;
+    }
+    if(probesBySearch(map,amount))
+    {
+        for(int i = 0; i < amount; i++)
+        {
+            Entry found = NULL;
+            if(keyElements[i] != NULL && !filterExcludes(map->filter,keyElements[i]))
+            {
+                found = mapFindEntry(map,keyElements[i]);
+            }
+            dataElements[i] = (found == NULL) ? NULL : found->data;
+        }
+        return MAP_SUCCESS;
     }
 
-    MapDataElement newData = map->copyDataFnc(data);
-    if(newData == NULL)
+    int* order = malloc(sizeof(int) * amount * 2);
+    if(order == NULL)
     {
         return MAP_OUT_OF_MEMORY;
     }
+    for(int i = 0; i < amount; i++)
+    {
+        order[i] = i;
+    }
+    sortKeysOrder(map,keyElements,order,order + amount,amount);
 
-    map->freeDataFnc(entry->data);
-   entry->data = newData;
+    Entry current = map->first;
+    for(int i = 0; i < amount; i++)
+    {
+        MapKeyElement key = keyElements[order[i]];
+        dataElements[order[i]] = NULL;
+        if(key == NULL)
+        {
+            continue;
+        }
+        while(current != NULL && map->compareKeyFnc(current->key,key) < 0)
+        {
+            current = current->next;
+        }
+        if(current != NULL && map->compareKeyFnc(current->key,key) == 0)
+        {
+            dataElements[order[i]] = current->data;
+        }
+    }
+
+    free(order);
     return MAP_SUCCESS;
 }
 
-MapResult putNewEntryMid(Map map, MapKeyElement key,MapDataElement data,Entry back,Entry front)
+MapDataElement mapConstGet(ConstMap map, MapKeyElement keyElement)
 {
-    if(map == NULL || key == NULL || data == NULL|| back == NULL)
+    if(map == NULL || keyElement == NULL || filterExcludes(map->filter,keyElement))
     {
-        return MAP_NULL_ARGUMENT;
+        return NULL;
     }
-   Entry newEntry = createNewEntry(map,key,data);
-    if(newEntry == NULL)
+
+    Entry found = mapFindEntry(map,keyElement);
+    return (found == NULL) ? NULL : found->data;
+}
+
+bool mapConstContains(ConstMap map, MapKeyElement keyElement)
+{
+    if(map == NULL || keyElement == NULL || filterExcludes(map->filter,keyElement))
     {
-        return MAP_OUT_OF_MEMORY;
+        return false;
     }
 
-    back->next = newEntry;
-    newEntry->next = front;
-    
-    return MAP_SUCCESS;
+    return mapFindEntry(map,keyElement) != NULL;
 }
 
-Entry createNewEntry(Map map , MapKeyElement key,MapDataElement data)
+int mapConstGetSize(ConstMap map)
 {
-    if(data == NULL|| key == NULL)
+    if(map == NULL)
     {
-        return NULL;
+        return EMPTY_NO_SIZE;
+    }
+    return map->size;
+}
+
+bool mapCursorFirst(ConstMap map, MapCursor* cursor)
+{
+    if(map == NULL || cursor == NULL)
+    {
+        return false;
+    }
+
+    cursor->position = map->first;
+    cursor->key = (map->first == NULL) ? NULL : map->first->key;
+    cursor->data = (map->first == NULL) ? NULL : map->first->data;
+    return cursor->position != NULL;
+}
+
+bool mapCursorNext(ConstMap map, MapCursor* cursor)
+{
+    if(map == NULL || cursor == NULL || cursor->position == NULL)
+    {
+        return false;
+    }
+
+    const struct entry_t* next = ((const struct entry_t*)cursor->position)->next;
+    cursor->position = next;
+    cursor->key = (next == NULL) ? NULL : next->key;
+    cursor->data = (next == NULL) ? NULL : next->data;
+    return cursor->position != NULL;
+}
+
+MapKeyElement mapCursorGetKey(const MapCursor* cursor)
+{
+    if(cursor == NULL || cursor->position == NULL)
+    {
+        return NULL;
+    }
+    return cursor->key;
+}
+
+MapDataElement mapCursorGetData(const MapCursor* cursor)
+{
+    if(cursor == NULL || cursor->position == NULL)
+    {
+        return NULL;
+    }
+    return cursor->data;
+}
+
+int mapAddIndex(Map map, projectMapElements projectElement,
+                compareMapKeyElements compareIndexKeys)
+{
+    if(map == NULL || projectElement == NULL || compareIndexKeys == NULL)
+    {
+        return INDEX_NOT_CREATED;
+    }
+    Index indexes = realloc(map->indexes,sizeof(struct index_t) * (map->index_count + 1));
+    if(indexes == NULL)
+    {
+        return INDEX_NOT_CREATED;
+    }
+    map->indexes = indexes;
+
+    Index index = &map->indexes[map->index_count];
+    index->projectFnc = projectElement;
+    index->compareFnc = compareIndexKeys;
+    index->records.root = NULL;
+    index->records.size = 0;
+    index->records.getKeyFnc = NULL;
+    index->records.compareKeyFnc = NULL;
+    index->spare = NULL;
+    if(indexBuild(map,index) != MAP_SUCCESS)
+    {
+        return INDEX_NOT_CREATED;
+    }
+    return map->index_count++;
+}
+
+int mapIndexCount(ConstMap map, int index, MapKeyElement indexKey)
+{
+    if(map == NULL || indexKey == NULL || index < 0 || index >= map->index_count)
+    {
+        return EMPTY_NO_SIZE;
+    }
+
+    const struct index_t* found = &map->indexes[index];
+    int count = 0;
+    const struct index_record_t* first = indexLowerBound(map,found,indexKey,NULL);
+    const MapNode* current = (first == NULL) ? NULL : &first->node;
+    while(current != NULL &&
+          found->compareFnc(MAP_NODE_ENTRY(current,struct index_record_t,node)->projected,indexKey) == 0)
+    {
+        count++;
+        current = intrusiveMapNext(current);
+    }
+    return count;
+}
+
+bool mapIndexCursorFirst(ConstMap map, int index, MapKeyElement indexKey, MapCursor* cursor)
+{
+    if(map == NULL || indexKey == NULL || cursor == NULL || index < 0 || index >= map->index_count)
+    {
+        return false;
+    }
+
+    const struct index_t* found = &map->indexes[index];
+    const struct index_record_t* first = indexLowerBound(map,found,indexKey,NULL);
+    if(first == NULL || found->compareFnc(first->projected,indexKey) != 0)
+    {
+        cursor->position = NULL;
+        cursor->key = NULL;
+        cursor->data = NULL;
+        return false;
+    }
+    cursor->position = first;
+    cursor->key = first->entry->key;
+    cursor->data = first->entry->data;
+    return true;
+}
+
+bool mapIndexCursorNext(ConstMap map, int index, MapCursor* cursor)
+{
+    if(map == NULL || cursor == NULL || cursor->position == NULL || index < 0 || index >= map->index_count)
+    {
+        return false;
+    }
+
+    const struct index_t* found = &map->indexes[index];
+    const struct index_record_t* current = cursor->position;
+    const MapNode* next_node = intrusiveMapNext(&current->node);
+    const struct index_record_t* next = (next_node == NULL) ? NULL : MAP_NODE_ENTRY(next_node,struct index_record_t,node);
+    if(next == NULL || found->compareFnc(next->projected,current->projected) != 0)
+    {
+        cursor->position = NULL;
+        cursor->key = NULL;
+        cursor->data = NULL;
+        return false;
+    }
+    cursor->position = next;
+    cursor->key = next->entry->key;
+    cursor->data = next->entry->data;
+    return true;
+}
+
+MapResult mapRebuild(Map map, size_t keySize, size_t dataSize)
+{
+    if(map == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+    if(map->size == 0)
+    {
+        freeSlabs(map);
+        return MAP_SUCCESS;
+    }
+
+    searchTreeDrop(map);
+    int capacity = map->size;
+    Entry slab = malloc(sizeof(struct entry_t) * capacity);
+    char* key_slab = (keySize > 0) ? malloc(keySize * capacity) : NULL;
+    char* data_slab = (dataSize > 0) ? malloc(dataSize * capacity) : NULL;
+    if(slab == NULL || (keySize > 0 && key_slab == NULL) || (dataSize > 0 && data_slab == NULL))
+    {
+        free(slab);
+        free(key_slab);
+        free(data_slab);
+        searchTreeAdapt(map);
+        return MAP_OUT_OF_MEMORY;
+    }
+
+    Entry current = map->first;
+    for(int i = 0; i < capacity; i++)
+    {
+        Entry relocated = &slab[i];
+        relocated->key = current->key;
+        relocated->data = current->data;
+        relocated->next = (i + 1 < capacity) ? &slab[i + 1] : NULL;
+        if(key_slab != NULL)
+        {
+            relocated->key = key_slab + keySize * i;
+            memcpy(relocated->key,current->key,keySize);
+        }
+        if(data_slab != NULL)
+        {
+            relocated->data = data_slab + dataSize * i;
+            memcpy(relocated->data,current->data,dataSize);
+        }
+        indexRelocateElement(map,current,relocated);
+        if(key_slab != NULL)
+        {
+            freeEntryKey(map,current->key);
+        }
+        if(data_slab != NULL)
+        {
+            freeEntryData(map,current->data);
+        }
+
+        Entry old = current;
+        current = current->next;
+        if(!slabHolds(map->slab,sizeof(struct entry_t),map->slab_capacity,old))
+        {
+            free(old);
+        }
+    }
+
+    free(map->slab);
+    map->slab = slab;
+    map->slab_capacity = capacity;
+    if(key_slab != NULL)
+    {
+        free(map->key_slab);
+        map->key_slab = key_slab;
+        map->key_slab_capacity = capacity;
+        map->key_size = keySize;
+    }
+    if(data_slab != NULL)
+    {
+        free(map->data_slab);
+        map->data_slab = data_slab;
+        map->data_slab_capacity = capacity;
+        map->data_size = dataSize;
+    }
+    map->first = slab;
+    map->iterator = NULL;
+    map->finger = NULL;
+    if(map->flat_layout)
+    {
+        flatFill(map);
+    }
+    searchTreeAdapt(map);
+    return MAP_SUCCESS;
+}
+
+MapResult mapEnableFilter(Map map, hashMapKeyElements hashKeyElement)
+{
+    if(map == NULL || hashKeyElement == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+    if(map->filter == NULL)
+    {
+        map->filter = malloc(sizeof(struct filter_t));
+        if(map->filter == NULL)
+        {
+            return MAP_OUT_OF_MEMORY;
+        }
+        map->filter->blocks = NULL;
+    }
+
+    map->filter->hashFnc = hashKeyElement;
+    memset(&map->filter->stats,0,sizeof(MapFilterStats));
+    filterBuild(map);
+    return MAP_SUCCESS;
+}
+
+MapResult mapGetFilterStats(Map map, MapFilterStats* stats)
+{
+    if(map == NULL || stats == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+    if(map->filter == NULL)
+    {
+        return MAP_ERROR;
+    }
+
+    *stats = map->filter->stats;
+    return MAP_SUCCESS;
+}
+
+MapResult mapEnableFinger(Map map)
+{
+    if(map == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+    map->finger_enabled = true;
+    return MAP_SUCCESS;
+}
+
+int mapRemoveIf(Map map, matchMapElements matchElement, void* context)
+{
+    if(map == NULL || matchElement == NULL)
+    {
+        return EMPTY_NO_SIZE;
+    }
+
+    /*Matching entries are unlinked and their elements freed right away. Their keys are set
+     * to NULL, which marks their index records and search nodes for the compaction below*/
+    int removed = 0;
+    Entry removed_entries = NULL;
+    Entry back = NULL;
+    Entry current = map->first;
+    while(current != NULL)
+    {
+        Entry next = current->next;
+        if(matchElement(current->key,current->data,context))
+        {
+            if(back == NULL)
+            {
+                map->first = next;
+            }
+            else
+            {
+                back->next = next;
+            }
+            freeEntryData(map,current->data);
+            freeEntryKey(map,current->key);
+            current->key = NULL;
+            current->next = removed_entries;
+            removed_entries = current;
+            removed++;
+        }
+        else
+        {
+            back = current;
+        }
+        current = next;
+    }
+
+    map->iterator = NULL;
+    if(removed == 0)
+    {
+        return 0;
+    }
+    for(int i = 0; i < map->index_count; i++)
+    {
+        nodeTreeCompact(&map->indexes[i].records,indexRecordDrop);
+    }
+    if(map->tree_layout)
+    {
+        nodeTreeCompact(&map->search_tree,searchNodeDrop);
+    }
+    if(map->flat_layout)
+    {
+        flatFill(map);
+    }
+    if(map->finger != NULL && map->finger->key == NULL)
+    {
+        map->finger = NULL;
+    }
+    while(removed_entries != NULL)
+    {
+        Entry next = removed_entries->next;
+        if(!slabHolds(map->slab,sizeof(struct entry_t),map->slab_capacity,removed_entries))
+        {
+            free(removed_entries);
+        }
+        removed_entries = next;
+    }
+
+    map->size -= removed;
+    searchTreeAdapt(map);
+    filterUpdateOnRemove(map,removed);
+    return removed;
+}
+
+Map mapCreateFlat(copyMapDataElements copyDataElement,
+                  copyMapKeyElements copyKeyElement,
+                  freeMapDataElements freeDataElement,
+                  freeMapKeyElements freeKeyElement,
+                  compareMapKeyElements compareKeyElements)
+{
+    Map newMap = mapCreate(copyDataElement,copyKeyElement,freeDataElement,freeKeyElement,compareKeyElements);
+    if(newMap == NULL)
+    {
+        return NULL;
+    }
+    if(flatEnable(newMap) != MAP_SUCCESS)
+    {
+        mapDestroy(newMap);
+        return NULL;
+    }
+    return newMap;
+}
+
+MapResult mapFreeze(Map map, size_t keySize, size_t dataSize)
+{
+    if(map == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+    if(!map->flat_layout && flatEnable(map) != MAP_SUCCESS)
+    {
+        return MAP_OUT_OF_MEMORY;
+    }
+    return mapRebuild(map,keySize,dataSize);
+}
+
+MapResult intrusiveMapInit(IntrusiveMap* map, getMapNodeKey getKey,
+                           compareMapKeyElements compareKeyElements)
+{
+    if(map == NULL || getKey == NULL || compareKeyElements == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+
+    map->root = NULL;
+    map->size = 0;
+    map->getKeyFnc = getKey;
+    map->compareKeyFnc = compareKeyElements;
+    return MAP_SUCCESS;
+}
+
+int intrusiveMapGetSize(const IntrusiveMap* map)
+{
+    if(map == NULL)
+    {
+        return EMPTY_NO_SIZE;
+    }
+    return map->size;
+}
+
+MapResult intrusiveMapInsert(IntrusiveMap* map, MapNode* node)
+{
+    if(map == NULL || node == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+
+    MapKeyElement key = map->getKeyFnc(node);
+    MapNode* parent = NULL;
+    MapNode** link = &map->root;
+    while(*link != NULL)
+    {
+        parent = *link;
+        int compare = map->compareKeyFnc(key,map->getKeyFnc(parent));
+        if(compare == 0)
+        {
+            return MAP_ITEM_ALREADY_EXISTS;
+        }
+        link = (compare < 0) ? &parent->left : &parent->right;
+    }
+
+    node->left = NULL;
+    node->right = NULL;
+    node->parent = parent;
+    node->height = 1;
+    node->count = 1;
+    *link = node;
+    map->size++;
+    nodeRebalance(map,parent);
+    return MAP_SUCCESS;
+}
+
+MapNode* intrusiveMapFind(const IntrusiveMap* map, MapKeyElement keyElement)
+{
+    if(map == NULL || keyElement == NULL)
+    {
+        return NULL;
+    }
+
+    MapNode* current = map->root;
+    while(current != NULL)
+    {
+        int compare = map->compareKeyFnc(keyElement,map->getKeyFnc(current));
+        if(compare == 0)
+        {
+            return current;
+        }
+        current = (compare < 0) ? current->left : current->right;
+    }
+    return NULL;
+}
+
+MapResult intrusiveMapRemove(IntrusiveMap* map, MapNode* node)
+{
+    if(map == NULL || node == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+
+    MapNode* rebalance_from = NULL;
+    if(node->left != NULL && node->right != NULL)
+    {
+        MapNode* successor = node->right;
+        while(successor->left != NULL)
+        {
+            successor = successor->left;
+        }
+        if(successor->parent == node)
+        {
+            rebalance_from = successor;
+        }
+        else
+        {
+            rebalance_from = successor->parent;
+            nodeReplaceChild(map,successor->parent,successor,successor->right);
+            successor->right = node->right;
+            successor->right->parent = successor;
+        }
+        successor->left = node->left;
+        successor->left->parent = successor;
+        nodeReplaceChild(map,node->parent,node,successor);
+    }
+    else
+    {
+        rebalance_from = node->parent;
+        nodeReplaceChild(map,node->parent,node,(node->left != NULL) ? node->left : node->right);
+    }
+
+    node->left = NULL;
+    node->right = NULL;
+    node->parent = NULL;
+    map->size--;
+    nodeRebalance(map,rebalance_from);
+    return MAP_SUCCESS;
+}
+
+MapNode* intrusiveMapFirst(const IntrusiveMap* map)
+{
+    if(map == NULL || map->root == NULL)
+    {
+        return NULL;
+    }
+
+    MapNode* current = map->root;
+    while(current->left != NULL)
+    {
+        current = current->left;
+    }
+    return current;
+}
+
+MapNode* intrusiveMapNext(const MapNode* node)
+{
+    if(node == NULL)
+    {
+        return NULL;
+    }
+
+    if(node->right != NULL)
+    {
+        MapNode* current = node->right;
+        while(current->left != NULL)
+        {
+            current = current->left;
+        }
+        return current;
+    }
+    while(node->parent != NULL && node->parent->right == node)
+    {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+int intrusiveMapRank(const IntrusiveMap* map, const MapNode* node)
+{
+    if(map == NULL || node == NULL)
+    {
+        return NOT_FOUND;
+    }
+
+    int rank = nodeCount(node->left);
+    while(node->parent != NULL)
+    {
+        if(node->parent->right == node)
+        {
+            rank += nodeCount(node->parent->left) + 1;
+        }
+        node = node->parent;
+    }
+    return rank;
+}
+
+MapNode* intrusiveMapAtRank(const IntrusiveMap* map, int rank)
+{
+    if(map == NULL || rank < 0 || rank >= map->size)
+    {
+        return NULL;
+    }
+
+    MapNode* current = map->root;
+    while(current != NULL)
+    {
+        int left_count = nodeCount(current->left);
+        if(rank == left_count)
+        {
+            return current;
+        }
+        if(rank < left_count)
+        {
+            current = current->left;
+        }
+        else
+        {
+            rank -= left_count + 1;
+            current = current->right;
+        }
+    }
+    return NULL;
+}
+
+/* ----------------------------------------------------------------------
+
+             non header-included function's defenitions(aid functions)
+
+------------------------------------------------------------------------*/
+
+void destroyEntry(Map map,Entry entry)
+{
+    if(entry != NULL)
+        {
+            indexRemoveElement(map,entry);
+            searchTreeUnlink(map,entry);
+            flatRemove(map,entry);
+            if(map->finger == entry)
+            {
+                map->finger = NULL;
+            }
+            freeEntryData(map,entry->data);
+            freeEntryKey(map,entry->key);
+            if(!slabHolds(map->slab,sizeof(struct entry_t),map->slab_capacity,entry))
+            {
+                free(entry);
+            }
+        }
+}
+
+
+MapResult mapRemoveAid(Map map,Entry back,PutResult putRes)
+{
+    MapResult result;
+     switch (putRes)
+   {
+   case PUT_EMPTY:
+        result =  removeFirstEntry(map);
+       break;
+   case PUT_FIRST:
+       result =  removeFirstEntry(map);
+       break;
+    case PUT_MID:
+        result =  removeMidLastEntry(map,back);
+       break;
+    case PUT_LAST:
+        result = removeMidLastEntry(map,back);
+       break;
+    case PUT_INITIALIZED:
+        result = MAP_ITEM_DOES_NOT_EXIST;
+        break;
+    default:
+        result = MAP_NULL_ARGUMENT;
+      break;
+   }
+
+    if(result == MAP_SUCCESS)
+    {
+        map->size--;
+        filterUpdateOnRemove(map,1);
+        searchTreeAdapt(map);
+    }
+    return result;
+}
+
+MapResult removeFirstEntry(Map map)
+{
+    if(map == NULL|| map->first == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+   Entry newFirst = map->first->next;
+    destroyEntry(map,map->first);
+    map->first = newFirst;
+    return MAP_SUCCESS; 
+}
+
+MapResult removeMidLastEntry(Map map,Entry back)
+{
+    if(map == NULL|| back == NULL||back->next == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+
+   Entry victim = back->next;
+   Entry front = victim->next;
+
+    destroyEntry(map,victim);
+    back->next = front;
+
+    return MAP_SUCCESS; 
+}
+
+MapResult mapPutAid(Map map, MapKeyElement key,MapDataElement data,Entry back,Entry front,PutResult putRes)
+{
+    SearchNode node = NULL;
+    if(putRes != PUT_REPLACE && (flatReserve(map) != MAP_SUCCESS || searchTreeReserve(map,&node) != MAP_SUCCESS))
+    {
+        return MAP_OUT_OF_MEMORY;
+    }
+    MapResult result;
+     switch (putRes)
+   {
+   case PUT_EMPTY:
+        result = putNewEntryEmptyMap(map,key,data);
+       break;
+   case PUT_FIRST:
+        result = putNewEntryFirst(map,key,data);
+       break;
+   case PUT_REPLACE:
+        result = replaceEntryData(map,front,key,data); 
+       break;
+    case PUT_MID:
+        result = putNewEntryMid(map,key,data,back,front);
+       break;
+    case PUT_LAST:
+        result = putNewEntryMid(map,key,data,back,NULL);
+       break;
+    default :
+        free(node);
+        return MAP_NULL_ARGUMENT;
+
+       
+   }
+
+   if(result == MAP_SUCCESS && putRes != PUT_REPLACE)
+   {
+       Entry newEntry = (back != NULL) ? back->next : map->first;
+       if(node != NULL)
+       {
+           searchTreeLink(map,node,newEntry);
+       }
+       flatInsert(map,newEntry);
+       if(map->finger_enabled)
+       {
+           map->finger = newEntry;
+       }
+       map->size++;
+       filterUpdateOnPut(map,key);
+       searchTreeAdapt(map);
+   }
+   else
+   {
+       free(node);
+   }
+   return result;
+}
+
+ MapResult putNewEntryEmptyMap(Map map, MapKeyElement key,MapDataElement data)
+{
+    if(map == NULL || key == NULL || data == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+   Entry newEntry = createNewEntry(map,key,data);
+    if(newEntry == NULL)
+    {
+        return MAP_OUT_OF_MEMORY;
+    }
+
+    map->first = newEntry;
+    return MAP_SUCCESS;
+}
+
+MapResult putNewEntryFirst(Map map, MapKeyElement key,MapDataElement data)
+{
+    if(map == NULL || key == NULL || data == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+   Entry newEntry = createNewEntry(map,key,data);
+    if(newEntry == NULL)
+    {
+        return MAP_OUT_OF_MEMORY;
+    }
+
+   Entry current = map->first;
+    map->first = newEntry;
+    newEntry->next = current;
+    return MAP_SUCCESS;
+}
+
+MapResult replaceEntryData(Map map,Entry entry, MapKeyElement key,MapDataElement data)
+{
+    if(map == NULL || key == NULL || data == NULL||entry == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+
+    if(indexReserve(map) != MAP_SUCCESS)
+    {
+        return MAP_OUT_OF_MEMORY;
+    }
+    MapDataElement newData = map->copyDataFnc(data);
+    if(newData == NULL)
+    {
+        return MAP_OUT_OF_MEMORY;
+    }
+
+    indexRemoveElement(map,entry);
+    freeEntryData(map,entry->data);
+   entry->data = newData;
+    indexInsertElement(map,entry);
+    return MAP_SUCCESS;
+}
+
+MapResult putNewEntryMid(Map map, MapKeyElement key,MapDataElement data,Entry back,Entry front)
+{
+    if(map == NULL || key == NULL || data == NULL|| back == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+   Entry newEntry = createNewEntry(map,key,data);
+    if(newEntry == NULL)
+    {
+        return MAP_OUT_OF_MEMORY;
+    }
+
+    back->next = newEntry;
+    newEntry->next = front;
+    
+    return MAP_SUCCESS;
+}
+
+Entry createNewEntry(Map map , MapKeyElement key,MapDataElement data)
+{
+    if(data == NULL|| key == NULL || indexReserve(map) != MAP_SUCCESS)
+    {
+        return NULL;
     }
    Entry newEntry = malloc(sizeof(struct entry_t));
     if(newEntry != NULL)
     {
-        newEntry->data = map->copyDataFnc(data);
-        if(newEntry->data == NULL)
+        newEntry->data = map->copyDataFnc(data);
+        if(newEntry->data == NULL)
+        {
+            free(newEntry);
+            return NULL;   
+        }
+
+        newEntry->key = map->copyKeyFnc(key);
+        if(newEntry->key == NULL)
+        {
+            free(newEntry->data);
+            free(newEntry);
+            return NULL;   
+        }
+        newEntry->next = NULL;
+        indexInsertElement(map,newEntry);
+    }
+    return newEntry;
+}
+
+MapResult mapCopyList(Map originalMap, Map destinationMap)
+{
+    if(originalMap == NULL || destinationMap == NULL || originalMap->first == NULL)
+    {
+        return MAP_SUCCESS;
+    }
+
+     Entry current = originalMap->first;
+    while(current != NULL)
+    {   
+        MapResult result = mapPut(destinationMap,current->key,current->data);
+        if(result != MAP_SUCCESS)
+        {
+            return result;
+        }
+        current = current->next;
+    }
+    return MAP_SUCCESS;
+}
+
+static Entry mapInsertNewEntry(Map map, MapKeyElement keyElement, MapDataElement dataElement,
+                               initMapDataElements initDataElement, Entry back)
+{
+    SearchNode node = NULL;
+    if(indexReserve(map) != MAP_SUCCESS || flatReserve(map) != MAP_SUCCESS ||
+       searchTreeReserve(map,&node) != MAP_SUCCESS)
+    {
+        return NULL;
+    }
+    Entry newEntry = malloc(sizeof(struct entry_t));
+    if(newEntry == NULL)
+    {
+        free(node);
+        return NULL;
+    }
+    newEntry->key = map->copyKeyFnc(keyElement);
+    if(newEntry->key == NULL)
+    {
+        free(newEntry);
+        free(node);
+        return NULL;
+    }
+    newEntry->data = (dataElement != NULL) ? dataElement : initDataElement(keyElement);
+    if(newEntry->data == NULL)
+    {
+        map->freeKeyFnc(newEntry->key);
+        free(newEntry);
+        free(node);
+        return NULL;
+    }
+
+    if(back == NULL)
+    {
+        newEntry->next = map->first;
+        map->first = newEntry;
+    }
+    else
+    {
+        newEntry->next = back->next;
+        back->next = newEntry;
+    }
+    map->size++;
+    filterUpdateOnPut(map,newEntry->key);
+    indexInsertElement(map,newEntry);
+    if(node != NULL)
+    {
+        searchTreeLink(map,node,newEntry);
+    }
+    flatInsert(map,newEntry);
+    searchTreeAdapt(map);
+    if(map->finger_enabled)
+    {
+        map->finger = newEntry;
+    }
+    return newEntry;
+}
+
+static Entry mapFindEntry(ConstMap map, MapKeyElement key)
+{
+    Entry back = NULL;
+    return mapFindPosition(map,key,&back);
+}
+
+static Entry mapFindPosition(ConstMap map, MapKeyElement key, Entry* back)
+{
+    *back = NULL;
+    if(map->flat_layout)
+    {
+        int position = flatLowerBound(map,key);
+        if(position > 0)
+        {
+            *back = map->flat_entries[position - 1];
+        }
+        if(position < map->flat_size && map->compareKeyFnc(map->flat_keys[position],key) == 0)
+        {
+            return map->flat_entries[position];
+        }
+        return NULL;
+    }
+    if(map->tree_layout)
+    {
+        const MapNode* current = map->search_tree.root;
+        while(current != NULL)
+        {
+            Entry entry = MAP_NODE_ENTRY(current,struct search_node_t,node)->entry;
+            int compare = map->compareKeyFnc(entry->key,key);
+            if(compare == 0)
+            {
+                const MapNode* previous = current->left;
+                if(previous != NULL)
+                {
+                    while(previous->right != NULL)
+                    {
+                        previous = previous->right;
+                    }
+                    *back = MAP_NODE_ENTRY(previous,struct search_node_t,node)->entry;
+                }
+                return entry;
+            }
+            if(compare < 0)
+            {
+                *back = entry;
+                current = current->right;
+            }
+            else
+            {
+                current = current->left;
+            }
+        }
+        return NULL;
+    }
+
+    Entry current = map->first;
+    while(current != NULL)
+    {
+        int compare = map->compareKeyFnc(current->key,key);
+        if(compare == 0)
+        {
+            return current;
+        }
+        if(compare > 0)
+        {
+            return NULL;
+        }
+        *back = current;
+        current = current->next;
+    }
+    return NULL;
+}
+
+static Entry mapFingerSearch(Map map, MapKeyElement key, Entry* back)
+{
+    Entry unused_back = NULL;
+    if(back == NULL)
+    {
+        back = &unused_back;
+    }
+    Entry finger = map->finger;
+    if(finger == NULL)
+    {
+        Entry found = mapFindPosition(map,key,back);
+        if(found != NULL && map->finger_enabled)
+        {
+            map->finger = found;
+        }
+        return found;
+    }
+
+    int compare = map->compareKeyFnc(finger->key,key);
+    if(compare == 0 && back == &unused_back)
+    {
+        return finger;
+    }
+    if(compare < 0)
+    {
+        bool list_layout = !map->tree_layout && !map->flat_layout;
+        Entry previous = finger;
+        Entry current = finger->next;
+        while(current != NULL)
+        {
+            compare = map->compareKeyFnc(current->key,key);
+            if(compare == 0)
+            {
+                *back = previous;
+                map->finger = current;
+                return current;
+            }
+            if(compare > 0 || !list_layout)
+            {
+                break;
+            }
+            previous = current;
+            current = current->next;
+        }
+        if(current == NULL || compare > 0)
+        {
+            *back = previous;
+            return NULL;
+        }
+    }
+
+    Entry found = mapFindPosition(map,key,back);
+    if(found != NULL)
+    {
+        map->finger = found;
+    }
+    return found;
+}
+
+static int indexCompareRecord(ConstMap map, const struct index_t* index, MapKeyElement projected,
+                              MapKeyElement key, const struct index_record_t* record)
+{
+    int compare = index->compareFnc(projected,record->projected);
+    if(compare != 0 || key == NULL)
+    {
+        return compare;
+    }
+    return map->compareKeyFnc(key,record->entry->key);
+}
+
+static IndexRecord indexLowerBound(ConstMap map, const struct index_t* index, MapKeyElement projected, MapKeyElement key)
+{
+    IndexRecord lower_bound = NULL;
+    MapNode* current = index->records.root;
+    while(current != NULL)
+    {
+        IndexRecord record = MAP_NODE_ENTRY(current,struct index_record_t,node);
+        if(indexCompareRecord(map,index,projected,key,record) > 0)
+        {
+            current = current->right;
+        }
+        else
+        {
+            lower_bound = record;
+            current = current->left;
+        }
+    }
+    return lower_bound;
+}
+
+static IndexRecord indexFindRecord(ConstMap map, const struct index_t* index, Entry entry)
+{
+    IndexRecord record = indexLowerBound(map,index,index->projectFnc(entry->key,entry->data),entry->key);
+    return (record != NULL && record->entry == entry) ? record : NULL;
+}
+
+static void indexLink(ConstMap map, Index index, IndexRecord record)
+{
+    MapNode* parent = NULL;
+    MapNode** link = &index->records.root;
+    while(*link != NULL)
+    {
+        parent = *link;
+        IndexRecord current = MAP_NODE_ENTRY(parent,struct index_record_t,node);
+        link = (indexCompareRecord(map,index,record->projected,record->entry->key,current) < 0) ?
+               &parent->left : &parent->right;
+    }
+    record->node.left = NULL;
+    record->node.right = NULL;
+    record->node.parent = parent;
+    record->node.height = 1;
+    record->node.count = 1;
+    *link = &record->node;
+    index->records.size++;
+    nodeRebalance(&index->records,parent);
+}
+
+static MapResult indexReserve(Map map)
+{
+    for(int i = 0; i < map->index_count; i++)
+    {
+        Index index = &map->indexes[i];
+        if(index->spare != NULL)
+        {
+            continue;
+        }
+        index->spare = malloc(sizeof(struct index_record_t));
+        if(index->spare == NULL)
+        {
+            return MAP_OUT_OF_MEMORY;
+        }
+    }
+    return MAP_SUCCESS;
+}
+
+static void indexInsertElement(Map map, Entry entry)
+{
+    for(int i = 0; i < map->index_count; i++)
+    {
+        Index index = &map->indexes[i];
+        IndexRecord record = index->spare;
+        index->spare = NULL;
+        record->projected = index->projectFnc(entry->key,entry->data);
+        record->entry = entry;
+        indexLink(map,index,record);
+    }
+}
+
+static void indexRemoveElement(Map map, Entry entry)
+{
+    for(int i = 0; i < map->index_count; i++)
+    {
+        Index index = &map->indexes[i];
+        IndexRecord record = indexFindRecord(map,index,entry);
+        if(record == NULL)
+        {
+            continue;
+        }
+        intrusiveMapRemove(&index->records,&record->node);
+        if(index->spare == NULL)
+        {
+            index->spare = record;
+        }
+        else
+        {
+            free(record);
+        }
+    }
+}
+
+static void indexRelocateElement(Map map, Entry old_entry, Entry new_entry)
+{
+    for(int i = 0; i < map->index_count; i++)
+    {
+        Index index = &map->indexes[i];
+        IndexRecord record = indexFindRecord(map,index,old_entry);
+        if(record != NULL)
+        {
+            record->projected = index->projectFnc(new_entry->key,new_entry->data);
+            record->entry = new_entry;
+        }
+    }
+}
+
+static MapResult indexBuild(Map map, Index index)
+{
+    MapNode* list = NULL;
+    for(Entry current = map->first; current != NULL; current = current->next)
+    {
+        IndexRecord record = malloc(sizeof(struct index_record_t));
+        if(record == NULL)
+        {
+            index->records.root = list;
+            indexDropRecords(index);
+            return MAP_OUT_OF_MEMORY;
+        }
+        record->projected = index->projectFnc(current->key,current->data);
+        record->entry = current;
+        record->node.left = NULL;
+        record->node.right = list;
+        list = &record->node;
+    }
+
+    list = indexSortRecords(map,index,list,map->size);
+    index->records.root = nodeVineToTree(&list,map->size,NULL);
+    index->records.size = map->size;
+    return MAP_SUCCESS;
+}
+
+static MapNode* indexSortRecords(ConstMap map, const struct index_t* index, MapNode* list, int amount)
+{
+    if(amount < 2)
+    {
+        return list;
+    }
+    MapNode* second = list;
+    for(int i = 1; i < amount / 2; i++)
+    {
+        second = second->right;
+    }
+    MapNode* second_start = second->right;
+    second->right = NULL;
+    MapNode* first = indexSortRecords(map,index,list,amount / 2);
+    second = indexSortRecords(map,index,second_start,amount - amount / 2);
+
+    MapNode head;
+    MapNode* tail = &head;
+    while(first != NULL && second != NULL)
+    {
+        IndexRecord second_record = MAP_NODE_ENTRY(second,struct index_record_t,node);
+        IndexRecord first_record = MAP_NODE_ENTRY(first,struct index_record_t,node);
+        if(indexCompareRecord(map,index,first_record->projected,first_record->entry->key,second_record) < 0)
+        {
+            tail->right = first;
+            first = first->right;
+        }
+        else
+        {
+            tail->right = second;
+            second = second->right;
+        }
+        tail = tail->right;
+    }
+    tail->right = (first != NULL) ? first : second;
+    return head.right;
+}
+
+static void indexDropRecords(Index index)
+{
+    MapNode* current = nodeTreeToVine(index->records.root);
+    while(current != NULL)
+    {
+        MapNode* next = current->right;
+        free(MAP_NODE_ENTRY(current,struct index_record_t,node));
+        current = next;
+    }
+    free(index->spare);
+    index->spare = NULL;
+    index->records.root = NULL;
+    index->records.size = 0;
+}
+
+static bool slabHolds(const void* slab, size_t element_size, int capacity, const void* element)
+{
+    if(slab == NULL)
+    {
+        return false;
+    }
+    uintptr_t start = (uintptr_t)slab;
+    uintptr_t address = (uintptr_t)element;
+    return address >= start && address < start + element_size * capacity;
+}
+
+static void freeEntryKey(Map map, MapKeyElement key)
+{
+    if(!slabHolds(map->key_slab,map->key_size,map->key_slab_capacity,key))
+    {
+        map->freeKeyFnc(key);
+    }
+}
+
+static void freeEntryData(Map map, MapDataElement data)
+{
+    if(!slabHolds(map->data_slab,map->data_size,map->data_slab_capacity,data))
+    {
+        map->freeDataFnc(data);
+    }
+}
+
+static void freeSlabs(Map map)
+{
+    free(map->slab);
+    free(map->key_slab);
+    free(map->data_slab);
+    map->slab = NULL;
+    map->key_slab = NULL;
+    map->data_slab = NULL;
+    map->slab_capacity = 0;
+    map->key_slab_capacity = 0;
+    map->data_slab_capacity = 0;
+}
+
+static int compareProbeKeys(Map map, MapKeyElement first, MapKeyElement second)
+{
+    if(first == NULL || second == NULL)
+    {
+        return (first == NULL) - (second == NULL);
+    }
+    return map->compareKeyFnc(first,second);
+}
+
+static bool probesBySearch(ConstMap map, int amount)
+{
+    if(!map->tree_layout && !map->flat_layout)
+    {
+        return false;
+    }
+    long search_cost = (long)amount * PROBE_SEARCH_FACTOR;
+    for(int size = map->size; size > 1; size /= 2)
+    {
+        search_cost += (long)amount * PROBE_SEARCH_FACTOR;
+    }
+    return search_cost < map->size;
+}
+
+static void sortKeysOrder(Map map, MapKeyElement* keys, int* order, int* buffer, int amount)
+{
+    for(int width = 1; width < amount; width *= 2)
+    {
+        for(int low = 0; low < amount; low += 2 * width)
         {
-            free(newEntry);
-            return NULL;   
+            int middle = (low + width < amount) ? low + width : amount;
+            int high = (low + 2 * width < amount) ? low + 2 * width : amount;
+            int left = low;
+            int right = middle;
+            for(int out = low; out < high; out++)
+            {
+                if(right >= high || (left < middle && compareProbeKeys(map,keys[order[left]],keys[order[right]]) <= 0))
+                {
+                    buffer[out] = order[left++];
+                }
+                else
+                {
+                    buffer[out] = order[right++];
+                }
+            }
+        }
+        memcpy(order,buffer,sizeof(int) * amount);
+    }
+}
+
+static MapNode* nodeTreeToVine(MapNode* root)
+{
+    MapNode head;
+    head.right = root;
+    MapNode* tail = &head;
+    MapNode* rest = root;
+    while(rest != NULL)
+    {
+        if(rest->left == NULL)
+        {
+            tail = rest;
+            rest = rest->right;
+        }
+        else
+        {
+            MapNode* left = rest->left;
+            rest->left = left->right;
+            left->right = rest;
+            rest = left;
+            tail->right = left;
         }
+    }
+    return head.right;
+}
 
-        newEntry->key = map->copyKeyFnc(key);
-        if(newEntry->key == NULL)
+static MapNode* nodeVineToTree(MapNode** vine, int amount, MapNode* parent)
+{
+    if(amount == 0)
+    {
+        return NULL;
+    }
+    MapNode* left = nodeVineToTree(vine,amount / 2,NULL);
+    MapNode* root = *vine;
+    *vine = root->right;
+    root->parent = parent;
+    root->left = left;
+    if(left != NULL)
+    {
+        left->parent = root;
+    }
+    root->right = nodeVineToTree(vine,amount - amount / 2 - 1,root);
+    nodeUpdate(root);
+    return root;
+}
+
+static void nodeTreeCompact(IntrusiveMap* tree, bool (*dropNode)(MapNode*))
+{
+    MapNode head;
+    head.right = NULL;
+    MapNode* tail = &head;
+    int kept = 0;
+    MapNode* current = nodeTreeToVine(tree->root);
+    while(current != NULL)
+    {
+        MapNode* next = current->right;
+        if(!dropNode(current))
         {
-            free(newEntry->data);
-            free(newEntry);
-            return NULL;   
+            tail->right = current;
+            tail = current;
+            kept++;
         }
-        newEntry->next = NULL;
-        
+        current = next;
     }
-    return newEntry;
+    tail->right = NULL;
+    MapNode* vine = head.right;
+    tree->root = nodeVineToTree(&vine,kept,NULL);
+    tree->size = kept;
 }
 
-void mapCopyList(Map originalMap, Map destinationMap)
+static bool indexRecordDrop(MapNode* node)
 {
-    if(originalMap == NULL || destinationMap == NULL || originalMap->first == NULL)
+    IndexRecord record = MAP_NODE_ENTRY(node,struct index_record_t,node);
+    if(record->entry->key != NULL)
+    {
+        return false;
+    }
+    free(record);
+    return true;
+}
+
+static bool searchNodeDrop(MapNode* node)
+{
+    SearchNode search_node = MAP_NODE_ENTRY(node,struct search_node_t,node);
+    if(search_node->entry->key != NULL)
+    {
+        return false;
+    }
+    free(search_node);
+    return true;
+}
+
+static uint64_t filterKeyHash(const struct filter_t* filter, MapKeyElement key)
+{
+    uint64_t hash = (uint64_t)filter->hashFnc(key);
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+static void filterAddKey(Filter filter, MapKeyElement key)
+{
+    uint64_t hash = filterKeyHash(filter,key);
+    uint64_t* block = filter->blocks + ((hash >> 32) * (uint64_t)filter->block_count >> 32) * FILTER_BLOCK_WORDS;
+    for(int i = 0; i < FILTER_HASHES; i++)
+    {
+        int bit = (int)(hash >> (i * FILTER_BIT_INDEX_WIDTH)) & (FILTER_BLOCK_BITS - 1);
+        block[bit / 64] |= (uint64_t)1 << (bit % 64);
+    }
+}
+
+static void filterBuild(Map map)
+{
+    Filter filter = map->filter;
+    free(filter->blocks);
+    filter->blocks = NULL;
+    filter->block_count = 0;
+    filter->capacity = 0;
+    filter->stale = 0;
+    if(map->size < FILTER_ACTIVATION_SIZE)
     {
         return;
     }
 
-     Entry current = originalMap->first;
+    int capacity = 2 * map->size;
+    if(capacity < FILTER_MIN_CAPACITY)
+    {
+        capacity = FILTER_MIN_CAPACITY;
+    }
+    int block_count = (capacity * FILTER_BITS_PER_KEY + FILTER_BLOCK_BITS - 1) / FILTER_BLOCK_BITS;
+    filter->blocks = calloc(block_count * FILTER_BLOCK_WORDS, sizeof(uint64_t));
+    if(filter->blocks == NULL)
+    {
+        return;
+    }
+    filter->block_count = block_count;
+    filter->capacity = capacity;
+
+    Entry current = map->first;
     while(current != NULL)
-    {   
-        mapPut(destinationMap,current->key,current->data);
+    {
+        filterAddKey(filter,current->key);
         current = current->next;
     }
 }
 
+static bool filterExcludes(const struct filter_t* filter, MapKeyElement key)
+{
+    if(filter == NULL || filter->blocks == NULL)
+    {
+        return false;
+    }
+
+    uint64_t hash = filterKeyHash(filter,key);
+    const uint64_t* block = filter->blocks + ((hash >> 32) * (uint64_t)filter->block_count >> 32) * FILTER_BLOCK_WORDS;
+    uint64_t missing = 0;
+    for(int i = 0; i < FILTER_HASHES; i++)
+    {
+        int bit = (int)(hash >> (i * FILTER_BIT_INDEX_WIDTH)) & (FILTER_BLOCK_BITS - 1);
+        missing |= ~block[bit / 64] & ((uint64_t)1 << (bit % 64));
+    }
+    return missing != 0;
+}
+
+static bool filterRejects(Map map, MapKeyElement key)
+{
+    Filter filter = map->filter;
+    if(filter == NULL || filter->blocks == NULL)
+    {
+        return false;
+    }
+
+    filter->stats.lookups++;
+    if(filterExcludes(filter,key))
+    {
+        filter->stats.definite_misses++;
+        return true;
+    }
+    return false;
+}
+
+static void filterCountFalsePositive(Map map)
+{
+    if(map->filter != NULL && map->filter->blocks != NULL)
+    {
+        map->filter->stats.false_positives++;
+    }
+}
+
+static void filterUpdateOnPut(Map map, MapKeyElement key)
+{
+    Filter filter = map->filter;
+    if(filter == NULL)
+    {
+        return;
+    }
+    if(filter->blocks == NULL || map->size > filter->capacity)
+    {
+        filterBuild(map);
+        return;
+    }
+    filterAddKey(filter,key);
+}
+
+static void filterUpdateOnRemove(Map map, int removed)
+{
+    Filter filter = map->filter;
+    if(filter == NULL || filter->blocks == NULL)
+    {
+        return;
+    }
+    filter->stale += removed;
+    if(filter->stale > filter->capacity / 2 || map->size < FILTER_ACTIVATION_SIZE)
+    {
+        filterBuild(map);
+    }
+}
+
+static int nodeHeight(const MapNode* node)
+{
+    return (node == NULL) ? 0 : node->height;
+}
+
+static int nodeCount(const MapNode* node)
+{
+    return (node == NULL) ? 0 : node->count;
+}
+
+static void nodeUpdate(MapNode* node)
+{
+    int left_height = nodeHeight(node->left);
+    int right_height = nodeHeight(node->right);
+    node->height = ((left_height > right_height) ? left_height : right_height) + 1;
+    node->count = nodeCount(node->left) + nodeCount(node->right) + 1;
+}
+
+static void nodeReplaceChild(IntrusiveMap* map, MapNode* parent, MapNode* old_child, MapNode* new_child)
+{
+    if(parent == NULL)
+    {
+        map->root = new_child;
+    }
+    else if(parent->left == old_child)
+    {
+        parent->left = new_child;
+    }
+    else
+    {
+        parent->right = new_child;
+    }
+    if(new_child != NULL)
+    {
+        new_child->parent = parent;
+    }
+}
+
+static MapNode* nodeRotateLeft(IntrusiveMap* map, MapNode* node)
+{
+    MapNode* pivot = node->right;
+    node->right = pivot->left;
+    if(pivot->left != NULL)
+    {
+        pivot->left->parent = node;
+    }
+    nodeReplaceChild(map,node->parent,node,pivot);
+    pivot->left = node;
+    node->parent = pivot;
+    nodeUpdate(node);
+    nodeUpdate(pivot);
+    return pivot;
+}
+
+static MapNode* nodeRotateRight(IntrusiveMap* map, MapNode* node)
+{
+    MapNode* pivot = node->left;
+    node->left = pivot->right;
+    if(pivot->right != NULL)
+    {
+        pivot->right->parent = node;
+    }
+    nodeReplaceChild(map,node->parent,node,pivot);
+    pivot->right = node;
+    node->parent = pivot;
+    nodeUpdate(node);
+    nodeUpdate(pivot);
+    return pivot;
+}
 
+static void nodeRebalance(IntrusiveMap* map, MapNode* node)
+{
+    while(node != NULL)
+    {
+        nodeUpdate(node);
+        int balance = nodeHeight(node->left) - nodeHeight(node->right);
+        if(balance > 1)
+        {
+            if(nodeHeight(node->left->left) < nodeHeight(node->left->right))
+            {
+                nodeRotateLeft(map,node->left);
+            }
+            node = nodeRotateRight(map,node);
+        }
+        else if(balance < -1)
+        {
+            if(nodeHeight(node->right->right) < nodeHeight(node->right->left))
+            {
+                nodeRotateRight(map,node->right);
+            }
+            node = nodeRotateLeft(map,node);
+        }
+        node = node->parent;
+    }
+}
 
+static MapKeyElement searchNodeKey(const MapNode* node)
+{
+    return MAP_NODE_ENTRY(node,struct search_node_t,node)->entry->key;
+}
 
+static void searchTreeLink(Map map, SearchNode node, Entry entry)
+{
+    node->entry = entry;
+    intrusiveMapInsert(&map->search_tree,&node->node);
+}
 
+static void searchTreeUnlink(Map map, Entry entry)
+{
+    if(!map->tree_layout)
+    {
+        return;
+    }
+    MapNode* found = intrusiveMapFind(&map->search_tree,entry->key);
+    if(found != NULL)
+    {
+        intrusiveMapRemove(&map->search_tree,found);
+        free(MAP_NODE_ENTRY(found,struct search_node_t,node));
+    }
+}
 
+static void searchTreeBuild(Map map)
+{
+    map->tree_layout = true;
+    for(Entry current = map->first; current != NULL; current = current->next)
+    {
+        SearchNode node = malloc(sizeof(struct search_node_t));
+        if(node == NULL)
+        {
+            searchTreeDrop(map);
+            return;
+        }
+        searchTreeLink(map,node,current);
+    }
+}
 
+static void searchTreeDrop(Map map)
+{
+    MapNode* current = map->search_tree.root;
+    while(current != NULL)
+    {
+        if(current->left != NULL)
+        {
+            current = current->left;
+        }
+        else if(current->right != NULL)
+        {
+            current = current->right;
+        }
+        else
+        {
+            MapNode* parent = current->parent;
+            if(parent != NULL && parent->left == current)
+            {
+                parent->left = NULL;
+            }
+            else if(parent != NULL)
+            {
+                parent->right = NULL;
+            }
+            free(MAP_NODE_ENTRY(current,struct search_node_t,node));
+            current = parent;
+        }
+    }
+    intrusiveMapInit(&map->search_tree,searchNodeKey,map->compareKeyFnc);
+    map->tree_layout = false;
+}
 
+static void searchTreeAdapt(Map map)
+{
+    if(map->flat_layout)
+    {
+        return;
+    }
+    if(!map->tree_layout && map->size > TREE_LAYOUT_MIN_SIZE)
+    {
+        searchTreeBuild(map);
+    }
+    else if(map->tree_layout && map->size <= TREE_LAYOUT_DROP_SIZE)
+    {
+        searchTreeDrop(map);
+    }
+}
 
+static MapResult searchTreeReserve(Map map, SearchNode* node)
+{
+    *node = NULL;
+    if(!map->tree_layout)
+    {
+        return MAP_SUCCESS;
+    }
+    *node = malloc(sizeof(struct search_node_t));
+    return (*node == NULL) ? MAP_OUT_OF_MEMORY : MAP_SUCCESS;
+}
 
+static MapResult flatEnable(Map map)
+{
+    int capacity = (map->size > FLAT_MIN_CAPACITY) ? map->size : FLAT_MIN_CAPACITY;
+    MapKeyElement* keys = malloc(sizeof(MapKeyElement) * capacity);
+    Entry* entries = malloc(sizeof(Entry) * capacity);
+    if(keys == NULL || entries == NULL)
+    {
+        free(keys);
+        free(entries);
+        return MAP_OUT_OF_MEMORY;
+    }
 
+    searchTreeDrop(map);
+    map->flat_keys = keys;
+    map->flat_entries = entries;
+    map->flat_capacity = capacity;
+    map->flat_layout = true;
+    flatFill(map);
+    return MAP_SUCCESS;
+}
 
+static void flatFill(Map map)
+{
+    int position = 0;
+    for(Entry current = map->first; current != NULL; current = current->next)
+    {
+        map->flat_keys[position] = current->key;
+        map->flat_entries[position] = current;
+        position++;
+    }
+    map->flat_size = position;
+}
 
+static int flatLowerBound(ConstMap map, MapKeyElement key)
+{
+    if(map->flat_size == 0)
+    {
+        return 0;
+    }
+    const MapKeyElement* keys = map->flat_keys;
+    int low = 0;
+    int length = map->flat_size;
+    while(length > 1)
+    {
+        int half = length / 2;
+        low = (map->compareKeyFnc(keys[low + half - 1],key) < 0) ? low + half : low;
+        length -= half;
+    }
+    return (map->compareKeyFnc(keys[low],key) < 0) ? low + 1 : low;
+}
 
+static MapResult flatReserve(Map map)
+{
+    if(!map->flat_layout || map->flat_size < map->flat_capacity)
+    {
+        return MAP_SUCCESS;
+    }
+    MapKeyElement* keys = realloc(map->flat_keys,sizeof(MapKeyElement) * map->flat_capacity * 2);
+    if(keys == NULL)
+    {
+        return MAP_OUT_OF_MEMORY;
+    }
+    map->flat_keys = keys;
+    Entry* entries = realloc(map->flat_entries,sizeof(Entry) * map->flat_capacity * 2);
+    if(entries == NULL)
+    {
+        return MAP_OUT_OF_MEMORY;
+    }
+    map->flat_entries = entries;
+    map->flat_capacity *= 2;
+    return MAP_SUCCESS;
+}
 
+static void flatInsert(Map map, Entry entry)
+{
+    if(!map->flat_layout)
+    {
+        return;
+    }
+    int position = flatLowerBound(map,entry->key);
+    memmove(&map->flat_keys[position + 1],&map->flat_keys[position],
+            sizeof(MapKeyElement) * (map->flat_size - position));
+    memmove(&map->flat_entries[position + 1],&map->flat_entries[position],
+            sizeof(Entry) * (map->flat_size - position));
+    map->flat_keys[position] = entry->key;
+    map->flat_entries[position] = entry;
+    map->flat_size++;
+}
 
+static void flatRemove(Map map, Entry entry)
+{
+    if(!map->flat_layout)
+    {
+        return;
+    }
+    int position = flatLowerBound(map,entry->key);
+    if(position < map->flat_size && map->flat_entries[position] == entry)
+    {
+        memmove(&map->flat_keys[position],&map->flat_keys[position + 1],
+                sizeof(MapKeyElement) * (map->flat_size - position - 1));
+        memmove(&map->flat_entries[position],&map->flat_entries[position + 1],
+                sizeof(Entry) * (map->flat_size - position - 1));
+        map->flat_size--;
+    }
+}
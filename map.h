@@ -2,6 +2,8 @@
 #define MAP_H_
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /**
 * Generic Map Container
@@ -32,6 +34,54 @@
 *   				  returns it.
 *	 mapClear		- Clears the contents of the map. Frees all the elements of
 *	 				  the map using the free function.
+*   mapEnableFilter - Attaches a negative lookup (Bloom) filter to the map so
+*   				  lookups of absent keys return without a search.
+*   mapGetFilterStats - Returns the lookup filter's hit/miss counters.
+*   mapGetOrInsert - Returns the data stored for a key, creating it first if
+*   				  the key is missing. One search in both cases.
+*   mapInsertOwned - Inserts a new key with a data element the map takes
+*   				  ownership of (instead of copying it).
+*   mapUpdate		- Mutates the data stored for a key in place.
+*   mapGetMany		- Looks up a batch of keys in a single sweep over the map.
+*   mapConstGet, mapConstContains, mapConstGetSize
+*   				- Read only versions of mapGet, mapContains and mapGetSize.
+*   				  They never write to the map, so any number of threads may
+*   				  call them concurrently on a map no one is modifying.
+*   mapCursorFirst, mapCursorNext
+*   				- Read only iteration using a caller owned cursor instead of
+*   				  the internal iterator.
+*   MAP_CURSOR_FOREACH - A macro for read only iteration with a cursor.
+*   mapAddIndex	- Registers a secondary ordered index over a projection of
+*   				  the map's elements, kept in sync by every modification.
+*   mapIndexCount	- Returns how many elements have a given projected key.
+*   mapIndexCursorFirst, mapIndexCursorNext
+*   				- Iterate with a cursor over the elements with a given
+*   				  projected key, in key order.
+*   MAP_INDEX_FOREACH - A macro for iterating over an index lookup.
+*   mapRebuild		- Relocates the map's elements into contiguous memory in key
+*   				  order, recovering locality after heavy insert/remove churn.
+*   mapEnableFinger - Makes the map remember its last accessed element, so
+*   				  repeated and adjacent lookups skip the search.
+*   mapRemoveIf	- Removes every element matching a predicate in a single
+*   				  pass over the map.
+*   mapCreateFlat	- Creates a new empty map in flat layout.
+*   mapFreeze		- Switches a read-mostly map to flat layout.
+*
+* An intrusive ordered map (IntrusiveMap) is also available. Its elements are
+* the caller's own structs, which embed a MapNode, so inserting and removing
+* never allocate, and a struct with several MapNode fields can sit in several
+* intrusive maps at once. The map neither copies nor frees its elements.
+*   intrusiveMapInit	- Initializes an empty intrusive map.
+*   intrusiveMapGetSize - Returns the amount of nodes in an intrusive map.
+*   intrusiveMapInsert - Links a node into an intrusive map.
+*   intrusiveMapFind	- Returns the node matching a key.
+*   intrusiveMapRemove - Unlinks a node from an intrusive map.
+*   intrusiveMapFirst, intrusiveMapNext
+*   				- Iterate over the nodes in key order.
+*   intrusiveMapRank	- Returns a node's position in key order.
+*   intrusiveMapAtRank - Returns the node at a given position in key order.
+*   MAP_NODE_ENTRY	- Returns the struct embedding a given MapNode.
+*   INTRUSIVE_MAP_FOREACH - A macro for iterating over an intrusive map.
 * 	 MAP_FOREACH	- A macro for iterating over the map's elements.
 */
 
@@ -48,12 +98,27 @@ typedef enum MapResult_t {
     MAP_ITEM_DOES_NOT_EXIST
 } MapResult;
 
+/** Type for read only access to a map. Functions taking a ConstMap never modify it */
+typedef const struct Map_t *ConstMap;
+
 /** Data element data type for map container */
 typedef void *MapDataElement;
 
 /** Key element data type for map container */
 typedef void *MapKeyElement;
 
+/**
+* Cursor for iterating over a map without using its internal iterator.
+* The cursor is owned by the caller (usually on the stack) and must only be
+* passed to the mapCursor functions. Like the internal iterator, a cursor is
+* invalidated by any function that adds or removes elements.
+*/
+typedef struct MapCursor_t {
+    const void* position;
+    MapKeyElement key;
+    MapDataElement data;
+} MapCursor;
+
 /** Type of function for copying a data element of the map */
 typedef MapDataElement(*copyMapDataElements)(MapDataElement);
 
@@ -76,6 +141,81 @@ typedef void(*freeMapKeyElements)(MapKeyElement);
 */
 typedef int(*compareMapKeyElements)(MapKeyElement, MapKeyElement);
 
+/**
+* Type of function for creating the initial data element of a key inserted by
+* mapGetOrInsert. The returned element is stored as is (it is not copied) and
+* is later deallocated by the map's free function.
+*/
+typedef MapDataElement(*initMapDataElements)(MapKeyElement);
+
+/**
+* Type of function projecting an element of the map (key and data) onto the key of
+* a secondary index. The returned key must point into the given key or data
+* element (it is not copied or freed by the map), and must stay equal as long as
+* the element is not modified. Modify projected fields only through mapUpdate or
+* mapPut, which keep the indexes in sync.
+*/
+typedef MapKeyElement(*projectMapElements)(MapKeyElement, MapDataElement);
+
+/**
+* Type of function deciding whether an element (key and data) of the map
+* matches, used by mapRemoveIf. Receives the context given to mapRemoveIf.
+* Must not modify the map.
+*/
+typedef bool(*matchMapElements)(MapKeyElement, MapDataElement, void*);
+
+/** Type of function for mutating a data element in place, used by mapUpdate */
+typedef void(*updateMapDataElements)(MapDataElement, void*);
+
+/**
+* Type of function used by the map's lookup filter to hash key elements.
+* Keys which are equal by the compare function must have equal hashes.
+*/
+typedef unsigned int(*hashMapKeyElements)(MapKeyElement);
+
+/**
+* Counters describing the effectiveness of a map's lookup filter.
+* @param lookups - lookups which were checked against the filter
+* @param definite_misses - lookups the filter rejected without searching the map
+* @param false_positives - lookups the filter passed although the key was absent
+*/
+typedef struct MapFilterStats_t {
+    int64_t lookups;
+    int64_t definite_misses;
+    int64_t false_positives;
+} MapFilterStats;
+
+/**
+* Node of an intrusive map, embedded by the caller inside its own struct.
+* Its fields are managed by the intrusive map functions only.
+*/
+typedef struct MapNode_t {
+    struct MapNode_t* left;
+    struct MapNode_t* right;
+    struct MapNode_t* parent;
+    int height;
+    int count;
+} MapNode;
+
+/**
+* Type of function returning the key of the struct embedding a given MapNode
+* (usually through MAP_NODE_ENTRY). The key must not change while the node is
+* in an intrusive map.
+*/
+typedef MapKeyElement(*getMapNodeKey)(const MapNode*);
+
+/**
+* Intrusive ordered map (a balanced tree of caller owned MapNodes).
+* Usually embedded in the caller's struct or declared on the stack, and
+* initialized with intrusiveMapInit.
+*/
+typedef struct IntrusiveMap_t {
+    MapNode* root;
+    int size;
+    getMapNodeKey getKeyFnc;
+    compareMapKeyElements compareKeyFnc;
+} IntrusiveMap;
+
 /**
 * mapCreate: Allocates a new empty map.
 *
@@ -232,6 +372,466 @@ MapKeyElement mapGetNext(Map map);
 */
 MapResult mapClear(Map map);
 
+/**
+* mapGetOrInsert: Returns the data associated with a key, inserting the key
+* first if it is not in the map. The key is copied using the copy function
+* given at initialization, and its data is created by initDataElement.
+* The returned pointer is the data element stored in the map (not a copy).
+* It may be mutated in place and stays valid until the key is removed or its
+* data is replaced by mapPut.
+* Iterator's value is undefined after this operation.
+*
+* @param map - The map to search in or insert into.
+* @param keyElement - The key element to find or insert.
+* @param initDataElement - Function pointer used for creating the data element
+* 		of a newly inserted key.
+* @param created - If not NULL, set to true if the key was inserted by this
+* 		call and to false if it already existed.
+* @return
+* 	NULL if a NULL was sent as map, keyElement or initDataElement, or an
+* 	allocation failed (the map is unchanged in that case).
+* 	The data element associated with the key otherwise.
+*/
+MapDataElement mapGetOrInsert(Map map, MapKeyElement keyElement,
+                              initMapDataElements initDataElement, bool* created);
+
+/**
+* mapInsertOwned: Inserts a key which is not in the map with a given data element,
+* which is stored as is (not copied): on success the map owns the data element and
+* later deallocates it by its free function. The key is copied as in mapPut.
+* Iterator's value is undefined after this operation.
+*
+* @param map - The map to insert into.
+* @param keyElement - The key element to insert.
+* @param dataElement - The data element to store. Stays the caller's if the insertion fails.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as map, keyElement or dataElement
+* 	MAP_ITEM_ALREADY_EXISTS if the key is already in the map (the map is unchanged)
+* 	MAP_OUT_OF_MEMORY if an allocation failed (the map is unchanged)
+* 	MAP_SUCCESS the pair was inserted successfully
+*/
+MapResult mapInsertOwned(Map map, MapKeyElement keyElement, MapDataElement dataElement);
+
+/**
+* mapUpdate: Mutates the data associated with a key in place by calling
+* updateDataElement with the stored data element and the given context.
+* Iterator status unchanged
+*
+* @param map - The map holding the key.
+* @param keyElement - The key element whose data should be updated.
+* @param updateDataElement - Function pointer applied to the stored data element.
+* @param context - Passed as is to updateDataElement.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as map, keyElement or updateDataElement
+* 	MAP_ITEM_DOES_NOT_EXIST if an equal key item does not exist in the map
+* 	MAP_SUCCESS the data element was updated
+*/
+MapResult mapUpdate(Map map, MapKeyElement keyElement,
+                    updateMapDataElements updateDataElement, void* context);
+
+/**
+* mapGetMany: Returns the data associated with each key of a batch.
+* The keys are sorted once and then resolved together in a single ordered
+* sweep over the map, instead of one search per key. A batch much smaller than
+* a large(tree or flat layout) map is resolved by a search per key instead,
+* so its cost does not follow the map's size.
+* Iterator status unchanged
+*
+* @param map - The map to get the data elements from.
+* @param keyElements - Array of amount key elements to look up. The keys do not
+* 		need to be sorted or distinct.
+* @param amount - Number of keys in keyElements.
+* @param dataElements - Array of amount elements. dataElements[i] is filled with the
+* 		data element (not a copy) associated with keyElements[i], or NULL if that key
+* 		is NULL or not in the map.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as map, keyElements or dataElements
+* 	MAP_ERROR if amount is negative
+* 	MAP_OUT_OF_MEMORY if an allocation failed
+* 	MAP_SUCCESS the data elements were filled successfully
+*/
+MapResult mapGetMany(Map map, MapKeyElement* keyElements, int amount,
+                     MapDataElement* dataElements);
+
+/**
+* mapConstGet: Returns the data associated with a specific key in the map.
+* Unlike mapGet it does not update the lookup filter's counters, so it writes
+* nothing and is safe to call concurrently with other read only functions.
+*
+* @param map - The map for which to get the data element from.
+* @param keyElement - The key element which need to be found.
+* @return
+*  NULL if a NULL pointer was sent or if the map does not contain the requested key.
+* 	The data element associated with the key otherwise.
+*/
+MapDataElement mapConstGet(ConstMap map, MapKeyElement keyElement);
+
+/**
+* mapConstContains: Checks if a key element exists in the map.
+* Read only version of mapContains.
+*
+* @param map - The map to search in
+* @param keyElement - The element to look for.
+* @return
+* 	false - if one or more of the inputs is null, or if the key element was not found.
+* 	true - if the key element was found in the map.
+*/
+bool mapConstContains(ConstMap map, MapKeyElement keyElement);
+
+/**
+* mapConstGetSize: Returns the number of elements in a map.
+* Read only version of mapGetSize.
+*
+* @param map - The map which size is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the number of elements in the map.
+*/
+int mapConstGetSize(ConstMap map);
+
+/**
+* mapCursorFirst: Positions a cursor on the smallest key element of the map.
+* The map's internal iterator is not used or changed.
+*
+* @param map - The map to iterate over.
+* @param cursor - The cursor to position.
+* @return
+* 	false if a NULL was sent or the map is empty.
+* 	true if the cursor is positioned on an element.
+*/
+bool mapCursorFirst(ConstMap map, MapCursor* cursor);
+
+/**
+* mapCursorNext: Advances a cursor to the next key element of the map.
+*
+* @param map - The map the cursor was positioned on by mapCursorFirst.
+* @param cursor - The cursor to advance.
+* @return
+* 	false if a NULL was sent or the cursor passed the last element.
+* 	true if the cursor is positioned on an element.
+*/
+bool mapCursorNext(ConstMap map, MapCursor* cursor);
+
+/**
+* mapCursorGetKey: Returns the key element under a positioned cursor.
+* The key is the one stored in the map (not a copy) and must not be modified
+* or freed.
+*
+* @param cursor - A cursor positioned on an element.
+* @return
+* 	NULL if a NULL was sent or the cursor is not positioned on an element.
+* 	The key element under the cursor otherwise.
+*/
+MapKeyElement mapCursorGetKey(const MapCursor* cursor);
+
+/**
+* mapCursorGetData: Returns the data element under a positioned cursor
+* (the element stored in the map, not a copy).
+*
+* @param cursor - A cursor positioned on an element.
+* @return
+* 	NULL if a NULL was sent or the cursor is not positioned on an element.
+* 	The data element under the cursor otherwise.
+*/
+MapDataElement mapCursorGetData(const MapCursor* cursor);
+
+/**
+* mapAddIndex: Registers a secondary ordered index on the map. Every element is
+* indexed under the key returned by projectElement, and the index is updated by
+* every function that adds, replaces, updates or removes elements. Several
+* elements may share a projected key. Indexes are copied by mapCopy (with the
+* same numbers). Each index is a balanced tree, so keeping it in sync costs
+* O(log n) per change; the records of elements already in the map are sorted
+* once and linked into the tree in a single pass.
+* Iterator status unchanged
+*
+* @param map - The map to index.
+* @param projectElement - Function pointer used for projecting an element onto
+* 		its index key.
+* @param compareIndexKeys - Function pointer used for comparing projected keys.
+* @return
+* 	-1 if a NULL was sent or an allocation failed.
+* 	Otherwise the number of the new index (0 for the map's first index, 1 for
+* 	its second, and so on), used for querying it.
+*/
+int mapAddIndex(Map map, projectMapElements projectElement,
+                compareMapKeyElements compareIndexKeys);
+
+/**
+* mapIndexCount: Returns the number of elements whose projected key is equal
+* to a given key in one of the map's indexes.
+*
+* @param map - The indexed map.
+* @param index - Index number returned by mapAddIndex.
+* @param indexKey - The projected key to look for.
+* @return
+* 	-1 if a NULL was sent or there is no such index.
+* 	Otherwise the number of matching elements.
+*/
+int mapIndexCount(ConstMap map, int index, MapKeyElement indexKey);
+
+/**
+* mapIndexCursorFirst: Positions a cursor on the first element (by the map's key
+* order) whose projected key is equal to a given key. mapCursorGetKey and
+* mapCursorGetData return the element's stored key and data.
+* Like mapCursorFirst, this writes nothing to the map.
+*
+* @param map - The indexed map.
+* @param index - Index number returned by mapAddIndex.
+* @param indexKey - The projected key to look for.
+* @param cursor - The cursor to position.
+* @return
+* 	false if a NULL was sent, there is no such index or no element matches.
+* 	true if the cursor is positioned on a matching element.
+*/
+bool mapIndexCursorFirst(ConstMap map, int index, MapKeyElement indexKey, MapCursor* cursor);
+
+/**
+* mapIndexCursorNext: Advances a cursor positioned by mapIndexCursorFirst to the
+* next element with the same projected key.
+*
+* @param map - The indexed map.
+* @param index - The index number the cursor was positioned with.
+* @param cursor - The cursor to advance.
+* @return
+* 	false if a NULL was sent or there are no more matching elements.
+* 	true if the cursor is positioned on a matching element.
+*/
+bool mapIndexCursorNext(ConstMap map, int index, MapCursor* cursor);
+
+/**
+* mapEnableFinger: Makes the map remember the last element it found, inserted
+* or iterated over (its "finger"). Looking up the finger's key again, or the
+* key following it, then costs one or two key comparisons, and in a small map
+* a search for a greater key starts from the finger instead of the first
+* element. Meant for maps accessed with strong locality, such as iterating with
+* mapGetNext and then calling mapGet for the same key.
+* The read only functions (mapConst*, mapCursor*) neither use nor move the
+* finger. Kept by mapCopy.
+* Iterator status unchanged
+*
+* @param map - The map to enable the finger on.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL pointer was sent.
+* 	MAP_SUCCESS otherwise.
+*/
+MapResult mapEnableFinger(Map map);
+
+/**
+* mapRemoveIf: Removes from the map every element for which matchElement
+* returns true, freeing their keys and data. The map is walked once and all
+* matches are unlinked during the walk, and the secondary indexes are then
+* compacted in one pass each, so removing k elements costs O(n) rather than
+* k separate searches.
+* The internal iterator is reset.
+*
+* @param map - The map to remove the elements from.
+* @param matchElement - Function pointer called once per element, in key order.
+* @param context - Passed to matchElement unchanged(may be NULL).
+* @return
+* 	-1 if a NULL pointer was sent as map or matchElement.
+* 	Otherwise the number of elements removed.
+*/
+int mapRemoveIf(Map map, matchMapElements matchElement, void* context);
+
+/**
+* mapCreateFlat: Allocates a new empty map in flat layout. A flat map is searched
+* by a binary search over a sorted array of its keys, so lookups cost O(log n)
+* with no pointer chasing, while adding or removing an element costs O(n).
+* Otherwise it behaves exactly like a map created by mapCreate.
+*
+* @param copyDataElement, copyKeyElement, freeDataElement, freeKeyElement,
+* 		compareKeyElements - Same as in mapCreate.
+* @return
+* 	NULL - if one of the parameters is NULL or allocations failed.
+* 	A new Map in case of success.
+*/
+Map mapCreateFlat(copyMapDataElements copyDataElement,
+                  copyMapKeyElements copyKeyElement,
+                  freeMapDataElements freeDataElement,
+                  freeMapKeyElements freeKeyElement,
+                  compareMapKeyElements compareKeyElements);
+
+/**
+* mapFreeze: Switches a map to flat layout (see mapCreateFlat), meant for maps
+* that will rarely change again, and relocates its elements as mapRebuild does.
+* The map stays fully usable: adding or removing elements keeps it in flat
+* layout, at O(n) per change. The layout is kept by mapCopy.
+* The internal iterator is reset.
+*
+* @param map - The map to freeze.
+* @param keySize - As in mapRebuild.
+* @param dataSize - As in mapRebuild.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL pointer was sent.
+* 	MAP_OUT_OF_MEMORY if an allocation failed. The map is unchanged, or is in
+* 	flat layout without its elements relocated.
+* 	MAP_SUCCESS otherwise.
+*/
+MapResult mapFreeze(Map map, size_t keySize, size_t dataSize);
+
+/**
+* mapRebuild: Relocates all of the map's entries into a single freshly allocated
+* block of memory, laid out in key order, and releases the memory they occupied
+* before. Optionally the key and/or data elements are relocated the same way.
+* Use this after heavy churn (many puts and removes) so scans over the map touch
+* contiguous memory again.
+* Relocating key or data elements is only allowed for fixed size elements which
+* are plain memory: they are moved with memcpy, and from then on the map releases
+* them itself instead of calling the free function given at initialization.
+* Relocating data elements invalidates data pointers returned by mapGet and
+* mapGetOrInsert.
+* Iterator's value is undefined after this operation.
+*
+* @param map - The map to rebuild.
+* @param keySize - Size in bytes of every key element, or 0 to leave the key
+* 		elements where they are.
+* @param dataSize - Size in bytes of every data element, or 0 to leave the data
+* 		elements where they are.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as map
+* 	MAP_OUT_OF_MEMORY if an allocation failed (the map is unchanged in that case)
+* 	MAP_SUCCESS the map was rebuilt successfully
+*/
+MapResult mapRebuild(Map map, size_t keySize, size_t dataSize);
+
+/**
+* mapEnableFilter: Attaches a blocked Bloom filter to the map. The filter is
+* maintained by mapPut/mapRemove and consulted by mapContains, mapGet and
+* mapRemove, so a lookup of a key which is not in the map usually returns
+* without searching. The filter is only built once the map grows past a few
+* elements, and it never changes the result of any map function.
+* Iterator status unchanged.
+*
+* @param map - The map to attach the filter to. If a filter is already
+* 		attached it is replaced.
+* @param hashKeyElement - Function pointer used for hashing key elements.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as map or hashKeyElement
+* 	MAP_OUT_OF_MEMORY if an allocation failed
+* 	MAP_SUCCESS the filter was attached successfully
+*/
+MapResult mapEnableFilter(Map map, hashMapKeyElements hashKeyElement);
+
+/**
+* mapGetFilterStats: Fills the counters of the map's lookup filter.
+* The false positive rate of the filter is
+* false_positives / (false_positives + definite_misses).
+*
+* @param map - The map whose filter counters are requested.
+* @param stats - Pointer to be filled with the counters.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as map or stats
+* 	MAP_ERROR if no filter is attached to the map
+* 	MAP_SUCCESS the counters were filled successfully
+*/
+MapResult mapGetFilterStats(Map map, MapFilterStats* stats);
+
+/**
+* intrusiveMapInit: Initializes an empty intrusive map.
+*
+* @param map - The intrusive map to initialize.
+* @param getKey - Function pointer used for getting the key of a node.
+* @param compareKeyElements - Function pointer used for comparing keys.
+* 		Same criterias as presented at mapCreate.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	MAP_SUCCESS otherwise.
+*/
+MapResult intrusiveMapInit(IntrusiveMap* map, getMapNodeKey getKey,
+                           compareMapKeyElements compareKeyElements);
+
+/**
+* intrusiveMapGetSize: Returns the number of nodes in an intrusive map
+* @param map - The intrusive map which size is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the number of nodes in the map.
+*/
+int intrusiveMapGetSize(const IntrusiveMap* map);
+
+/**
+* intrusiveMapInsert: Links a node into an intrusive map, in the position of its
+* key. Nothing is allocated or copied: the node stays owned by the caller and
+* must stay in place until it is removed.
+*
+* @param map - The intrusive map to insert the node into.
+* @param node - The node to insert. Must not be in this map already.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	MAP_ITEM_ALREADY_EXISTS if a node with an equal key is already in the map
+* 		(the map is unchanged)
+* 	MAP_SUCCESS the node had been inserted successfully
+*/
+MapResult intrusiveMapInsert(IntrusiveMap* map, MapNode* node);
+
+/**
+* intrusiveMapFind: Returns the node whose key matches a given key.
+*
+* @param map - The intrusive map to search in.
+* @param keyElement - The key to look for.
+* @return
+* 	NULL if a NULL pointer was sent or no node matches the key.
+* 	The matching node otherwise.
+*/
+MapNode* intrusiveMapFind(const IntrusiveMap* map, MapKeyElement keyElement);
+
+/**
+* intrusiveMapRemove: Unlinks a node from an intrusive map. Nothing is freed:
+* the node (and its struct) stay owned by the caller.
+*
+* @param map - The intrusive map to remove the node from.
+* @param node - The node to remove. Must be in this map.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	MAP_SUCCESS the node had been removed successfully
+*/
+MapResult intrusiveMapRemove(IntrusiveMap* map, MapNode* node);
+
+/**
+* intrusiveMapFirst: Returns the node with the smallest key.
+*
+* @param map - The intrusive map.
+* @return
+* 	NULL if a NULL pointer was sent or the map is empty.
+* 	The first node otherwise.
+*/
+MapNode* intrusiveMapFirst(const IntrusiveMap* map);
+
+/**
+* intrusiveMapNext: Returns the node following a given node in key order.
+*
+* @param node - A node in an intrusive map.
+* @return
+* 	NULL if a NULL pointer was sent or the node is the last one.
+* 	The next node otherwise.
+*/
+MapNode* intrusiveMapNext(const MapNode* node);
+
+/**
+* intrusiveMapRank: Returns the position of a node in key order (0 for the
+* first node). Takes time logarithmic in the map's size.
+*
+* @param map - The intrusive map.
+* @param node - A node in the map.
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	The node's position otherwise.
+*/
+int intrusiveMapRank(const IntrusiveMap* map, const MapNode* node);
+
+/**
+* intrusiveMapAtRank: Returns the node at a given position in key order (0 for
+* the first node). Takes time logarithmic in the map's size.
+*
+* @param map - The intrusive map.
+* @param rank - The requested position.
+* @return
+* 	NULL if a NULL pointer was sent or rank is out of range.
+* 	The node at the position otherwise.
+*/
+MapNode* intrusiveMapAtRank(const IntrusiveMap* map, int rank);
+
 /*!
 * Macro for iterating over a map.
 * Declares a new iterator for the loop.
@@ -241,4 +841,41 @@ MapResult mapClear(Map map);
         iterator ;\
         iterator = mapGetNext(map))
 
+/*!
+* Macro for read only iteration over a map with a cursor.
+* Declares a new MapCursor for the loop. Keys and data are read with
+* mapCursorGetKey and mapCursorGetData.
+*/
+#define MAP_CURSOR_FOREACH(cursor, map) \
+    for(MapCursor cursor, *cursor##_valid = (mapCursorFirst(map, &cursor) ? &cursor : NULL) ; \
+        cursor##_valid ;\
+        cursor##_valid = (mapCursorNext(map, &cursor) ? &cursor : NULL))
+
+/*!
+* Macro for iterating over the elements of a map whose projected key in a given
+* index equals indexKey. Declares a new MapCursor for the loop.
+* The loop must not modify the map.
+*/
+#define MAP_INDEX_FOREACH(cursor, map, index, indexKey) \
+    for(MapCursor cursor, *cursor##_valid = (mapIndexCursorFirst(map, index, indexKey, &cursor) ? &cursor : NULL) ; \
+        cursor##_valid ;\
+        cursor##_valid = (mapIndexCursorNext(map, index, &cursor) ? &cursor : NULL))
+
+/*!
+* Macro returning a pointer to the struct of a given type that embeds a given
+* MapNode as its member field.
+*/
+#define MAP_NODE_ENTRY(node, type, member) \
+    ((type*)((char*)(node) - offsetof(type, member)))
+
+/*!
+* Macro for iterating over the nodes of an intrusive map in key order.
+* Declares a new MapNode pointer for the loop. The loop must not remove the
+* current node.
+*/
+#define INTRUSIVE_MAP_FOREACH(node, map) \
+    for(MapNode* node = intrusiveMapFirst(map) ; \
+        node ;\
+        node = intrusiveMapNext(node))
+
 #endif /* MAP_H_ */
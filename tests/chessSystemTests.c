@@ -0,0 +1,487 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../chessSystem.h"
+#include "./test_utilities.h"
+
+/*The number of tests*/
+#define NUMBER_TESTS 7
+
+#define OUTPUT_SIZE 4096
+#define SNAPSHOT_FILE "chessSystemTests.snapshot"
+#define LOG_FILE "chessSystemTests.log"
+#define GAMES_FILE "chessSystemTests.games"
+#define STATISTICS_FILE "chessSystemTests.statistics"
+#define THREADS_AMOUNT 4
+#define THREAD_PLAYERS 12
+
+/*Reads a whole file into buffer(as a string), false if it could not be read*/
+static bool readFile(FILE* file, char* buffer)
+{
+    rewind(file);
+    size_t length = fread(buffer, 1, OUTPUT_SIZE - 1, file);
+    buffer[length] = '\0';
+    return ferror(file) == 0;
+}
+
+/*Checks that two systems have the same players levels, tournament statistics and tournament leaders*/
+static bool sameSystems(ChessSystem first, ChessSystem second, int max_tournament_id)
+{
+    char first_output[OUTPUT_SIZE], second_output[OUTPUT_SIZE];
+    FILE* first_file = tmpfile();
+    FILE* second_file = tmpfile();
+    bool same = first_file != NULL && second_file != NULL &&
+                chessSavePlayersLevels(first, first_file) == CHESS_SUCCESS &&
+                chessSavePlayersLevels(second, second_file) == CHESS_SUCCESS &&
+                readFile(first_file, first_output) && readFile(second_file, second_output) &&
+                strcmp(first_output, second_output) == 0;
+    if (first_file != NULL)
+    {
+        fclose(first_file);
+    }
+    if (second_file != NULL)
+    {
+        fclose(second_file);
+    }
+    if (!same)
+    {
+        return false;
+    }
+
+    ChessResult first_result = chessSaveTournamentStatistics(first, STATISTICS_FILE);
+    first_file = fopen(STATISTICS_FILE, "r");
+    same = first_file == NULL || readFile(first_file, first_output);
+    if (first_file != NULL)
+    {
+        fclose(first_file);
+    }
+    ChessResult second_result = chessSaveTournamentStatistics(second, STATISTICS_FILE);
+    second_file = fopen(STATISTICS_FILE, "r");
+    same = same && (second_file == NULL || readFile(second_file, second_output));
+    if (second_file != NULL)
+    {
+        fclose(second_file);
+    }
+    remove(STATISTICS_FILE);
+    if (!same || first_result != second_result ||
+        (first_result == CHESS_SUCCESS && strcmp(first_output, second_output) != 0))
+    {
+        return false;
+    }
+
+    for (int tournament_id = 1; tournament_id <= max_tournament_id; tournament_id++)
+    {
+        if (chessGetTournamentLeader(first, tournament_id, &first_result) !=
+                chessGetTournamentLeader(second, tournament_id, &second_result) ||
+            first_result != second_result)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*Counts the lines chessImportGamesFile reported, keeping the last one*/
+typedef struct
+{
+    int errors;
+    long last_line;
+    ChessResult last_result;
+} ImportErrors;
+
+static void countImportError(void* context, long line_number, ChessResult result)
+{
+    ImportErrors* errors = context;
+    errors->errors++;
+    errors->last_line = line_number;
+    errors->last_result = result;
+}
+
+/*A thread adding the games of a single tournament, between the same players as the other threads*/
+typedef struct
+{
+    ChessSystem chess;
+    int tournament_id;
+    bool succeeded;
+} TournamentThread;
+
+static void addTournamentGames(ChessSystem chess, int tournament_id, bool* succeeded)
+{
+    *succeeded = true;
+    for (int first = 1; first <= THREAD_PLAYERS; first++)
+    {
+        for (int second = first + 1; second <= THREAD_PLAYERS; second++)
+        {
+            Winner winner = (Winner)((first + second + tournament_id) % 3);
+            if (chessAddGame(chess, tournament_id, first, second, winner, first * second) != CHESS_SUCCESS)
+            {
+                *succeeded = false;
+            }
+            ChessResult result;
+            chessCalculateAveragePlayTime(chess, first, &result);
+            chessGetTournamentLeader(chess, tournament_id, &result);
+        }
+    }
+}
+
+static void* tournamentThread(void* argument)
+{
+    TournamentThread* thread = argument;
+    addTournamentGames(thread->chess, thread->tournament_id, &thread->succeeded);
+    return NULL;
+}
+
+bool testChessRemoveBothPlayersOfGame()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 3, DRAW, 20) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(chess, 2) == CHESS_PLAYER_NOT_EXIST);
+
+    ChessResult result;
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 3, &result) == 20);
+    ASSERT_TEST(result == CHESS_SUCCESS);
+    ASSERT_TEST(chessGetTournamentLeader(chess, 1, &result) == 3);
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessAddGames()
+{
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 2, "London") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 2, 4, "Paris") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(expected, 1, 2, "London") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(expected, 2, 4, "Paris") == CHESS_SUCCESS);
+
+    ChessGameRecord games[] = {
+        {1, 1, 2, FIRST_PLAYER, 10},
+        {2, 1, 2, SECOND_PLAYER, 20},
+        {1, 2, 1, DRAW, 5},
+        {1, 1, 3, DRAW, 7},
+        {1, 1, 4, FIRST_PLAYER, 3},
+        {3, 1, 2, DRAW, 1},
+        {2, 3, 3, DRAW, 1},
+        {2, 3, 4, FIRST_PLAYER, -1},
+        {2, 3, 4, SECOND_PLAYER, 30}
+    };
+    ChessResult expected_results[] = {
+        CHESS_SUCCESS, CHESS_SUCCESS, CHESS_GAME_ALREADY_EXISTS, CHESS_SUCCESS, CHESS_EXCEEDED_GAMES,
+        CHESS_TOURNAMENT_NOT_EXIST, CHESS_INVALID_ID, CHESS_INVALID_PLAY_TIME, CHESS_SUCCESS
+    };
+    int games_amount = sizeof(games) / sizeof(games[0]);
+    ChessResult results[sizeof(games) / sizeof(games[0])];
+    ASSERT_TEST(chessAddGames(chess, games, games_amount, results) == CHESS_SUCCESS);
+    for (int i = 0; i < games_amount; i++)
+    {
+        ASSERT_TEST(results[i] == expected_results[i]);
+        ASSERT_TEST(chessAddGame(expected, games[i].tournament_id, games[i].first_player, games[i].second_player,
+                                 games[i].winner, games[i].play_time) == expected_results[i]);
+    }
+    ASSERT_TEST(sameSystems(chess, expected, 2));
+    ASSERT_TEST(chessAddGames(chess, NULL, 1, results) == CHESS_NULL_ARGUMENT);
+    ASSERT_TEST(chessAddGames(chess, games, 0, NULL) == CHESS_SUCCESS);
+
+    ASSERT_TEST(chessSetIngestThreads(chess, THREADS_AMOUNT) == CHESS_SUCCESS);
+    ChessGameRecord more_games[] = {
+        {1, 5, 6, FIRST_PLAYER, 8},
+        {2, 5, 6, DRAW, 9},
+        {2, 5, 1, SECOND_PLAYER, 2},
+        {1, 6, 7, SECOND_PLAYER, 4}
+    };
+    int more_amount = sizeof(more_games) / sizeof(more_games[0]);
+    ASSERT_TEST(chessAddGames(chess, more_games, more_amount, results) == CHESS_SUCCESS);
+    for (int i = 0; i < more_amount; i++)
+    {
+        ASSERT_TEST(results[i] == CHESS_SUCCESS);
+        ASSERT_TEST(chessAddGame(expected, more_games[i].tournament_id, more_games[i].first_player,
+                                 more_games[i].second_player, more_games[i].winner,
+                                 more_games[i].play_time) == CHESS_SUCCESS);
+    }
+    ASSERT_TEST(sameSystems(chess, expected, 2));
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testChessSnapshotRoundTrip()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 2, 4, "Tel aviv") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 3, DRAW, 20) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 3, 4, SECOND_PLAYER, 30) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 3, SECOND_PLAYER, 15) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 4, 5, DRAW, 25) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS);
+
+    ASSERT_TEST(chessSaveSnapshot(chess, SNAPSHOT_FILE) == CHESS_SUCCESS);
+    ChessSystem loaded = chessLoadSnapshot(SNAPSHOT_FILE);
+    ASSERT_TEST(loaded != NULL);
+    ASSERT_TEST(sameSystems(chess, loaded, 2));
+
+    /*The loaded system keeps working as the original does*/
+    ASSERT_TEST(chessAddGame(loaded, 1, 5, 6, DRAW, 1) == CHESS_TOURNAMENT_ENDED);
+    ASSERT_TEST(chessAddGame(loaded, 2, 1, 3, DRAW, 1) == CHESS_GAME_ALREADY_EXISTS);
+    ASSERT_TEST(chessAddGame(loaded, 2, 2, 3, DRAW, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 2, 3, DRAW, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(loaded, 3) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(chess, 3) == CHESS_SUCCESS);
+    ASSERT_TEST(sameSystems(chess, loaded, 2));
+    chessDestroy(loaded);
+
+    /*A snapshot cut short is not loaded*/
+    FILE* file = fopen(SNAPSHOT_FILE, "r+b");
+    ASSERT_TEST(file != NULL);
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    char* content = malloc(size);
+    ASSERT_TEST(content != NULL);
+    file = fopen(SNAPSHOT_FILE, "rb");
+    ASSERT_TEST(fread(content, 1, size, file) == (size_t)size);
+    fclose(file);
+    file = fopen(SNAPSHOT_FILE, "wb");
+    fwrite(content, 1, size / 2, file);
+    fclose(file);
+    free(content);
+    ASSERT_TEST(chessLoadSnapshot(SNAPSHOT_FILE) == NULL);
+    ASSERT_TEST(chessLoadSnapshot(NULL) == NULL);
+
+    remove(SNAPSHOT_FILE);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessRecoverFromLog()
+{
+    remove(LOG_FILE);
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessSyncLog(chess) == CHESS_NULL_ARGUMENT);
+    ASSERT_TEST(chessAttachLog(chess, LOG_FILE, CHESS_LOG_SYNC_BATCH, 3) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAttachLog(chess, LOG_FILE, CHESS_LOG_SYNC_BATCH, 3) == CHESS_SAVE_FAILURE);
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 3, DRAW, 20) == CHESS_SUCCESS);
+    ASSERT_TEST(chessSaveSnapshot(chess, SNAPSHOT_FILE) == CHESS_SUCCESS);
+
+    ASSERT_TEST(chessAddTournament(chess, 2, 4, "Paris") == CHESS_SUCCESS);
+    ChessGameRecord games[] = {
+        {2, 1, 3, SECOND_PLAYER, 15},
+        {2, 4, 5, DRAW, 25}
+    };
+    ChessResult results[2];
+    ASSERT_TEST(chessAddGames(chess, games, 2, results) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessSyncLog(chess) == CHESS_SUCCESS);
+
+    ChessSystem recovered = chessRecover(SNAPSHOT_FILE, LOG_FILE);
+    ASSERT_TEST(recovered != NULL);
+    ASSERT_TEST(sameSystems(chess, recovered, 2));
+    chessDestroy(recovered);
+    recovered = chessRecover(NULL, LOG_FILE);
+    ASSERT_TEST(recovered != NULL);
+    ASSERT_TEST(sameSystems(chess, recovered, 2));
+    chessDestroy(recovered);
+    ASSERT_TEST(chessRecover(SNAPSHOT_FILE, NULL) == NULL);
+
+    ASSERT_TEST(chessDetachLog(chess) == CHESS_SUCCESS);
+    ASSERT_TEST(chessDetachLog(chess) == CHESS_NULL_ARGUMENT);
+    remove(SNAPSHOT_FILE);
+    remove(LOG_FILE);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessRecoverTornLog()
+{
+    remove(LOG_FILE);
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chessAttachLog(chess, LOG_FILE, CHESS_LOG_SYNC_EVERY_COMMIT, 0) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(expected, 1, 4, "London") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(expected, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS);
+    FILE* file = fopen(LOG_FILE, "rb");
+    ASSERT_TEST(file != NULL);
+    fseek(file, 0, SEEK_END);
+    long committed_size = ftell(file);
+    fclose(file);
+
+    /*The last record is torn, as if the system crashed while writing it*/
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 3, DRAW, 20) == CHESS_SUCCESS);
+    ASSERT_TEST(chessDetachLog(chess) == CHESS_SUCCESS);
+    file = fopen(LOG_FILE, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    ASSERT_TEST(size > committed_size + 2);
+    char* content = malloc(size);
+    ASSERT_TEST(content != NULL);
+    rewind(file);
+    ASSERT_TEST(fread(content, 1, size, file) == (size_t)size);
+    fclose(file);
+    file = fopen(LOG_FILE, "wb");
+    fwrite(content, 1, size - 2, file);
+    fclose(file);
+    free(content);
+
+    ChessSystem recovered = chessRecover(NULL, LOG_FILE);
+    ASSERT_TEST(recovered != NULL);
+    ASSERT_TEST(sameSystems(expected, recovered, 1));
+    file = fopen(LOG_FILE, "rb");
+    fseek(file, 0, SEEK_END);
+    ASSERT_TEST(ftell(file) == committed_size);
+    fclose(file);
+
+    /*The cut log can be attached again and keeps recording*/
+    ASSERT_TEST(chessAttachLog(recovered, LOG_FILE, CHESS_LOG_SYNC_EVERY_COMMIT, 0) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(recovered, 1, 2, 3, SECOND_PLAYER, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(expected, 1, 2, 3, SECOND_PLAYER, 5) == CHESS_SUCCESS);
+    chessDestroy(recovered);
+    recovered = chessRecover(NULL, LOG_FILE);
+    ASSERT_TEST(recovered != NULL);
+    ASSERT_TEST(sameSystems(expected, recovered, 1));
+
+    remove(LOG_FILE);
+    chessDestroy(recovered);
+    chessDestroy(expected);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessImportGamesFile()
+{
+    FILE* file = fopen(GAMES_FILE, "w");
+    ASSERT_TEST(file != NULL);
+    fputs("1 1 2 0 10\n", file);
+    fputs("\n", file);
+    fputs("1,2,3,2,20\r\n", file);
+    fputs("1 3 4 two 30\n", file);
+    fputs("1\t2 1 1 5\n", file);
+    fputs("2 3 4 1 7", file);
+    fclose(file);
+
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 2, 4, "Paris") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(expected, 1, 4, "London") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(expected, 2, 4, "Paris") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(expected, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(expected, 1, 2, 3, DRAW, 20) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(expected, 2, 3, 4, SECOND_PLAYER, 7) == CHESS_SUCCESS);
+
+    ChessImportReport report;
+    ImportErrors errors = {0, 0, CHESS_SUCCESS};
+    ASSERT_TEST(chessImportGamesFile(chess, GAMES_FILE, &report, countImportError, &errors) == CHESS_SUCCESS);
+    ASSERT_TEST(report.lines == 5);
+    ASSERT_TEST(report.games_added == 3);
+    ASSERT_TEST(report.malformed_lines == 1);
+    ASSERT_TEST(report.rejected_games == 1);
+    ASSERT_TEST(report.bytes > 0);
+    ASSERT_TEST(errors.errors == 2);
+    ASSERT_TEST(errors.last_line == 5);
+    ASSERT_TEST(errors.last_result == CHESS_GAME_ALREADY_EXISTS);
+    ASSERT_TEST(sameSystems(chess, expected, 2));
+
+    ASSERT_TEST(chessImportGamesFile(chess, "chessSystemTests.missing", NULL, NULL, NULL) == CHESS_SAVE_FAILURE);
+    ASSERT_TEST(chessImportGamesFile(chess, NULL, NULL, NULL, NULL) == CHESS_NULL_ARGUMENT);
+    remove(GAMES_FILE);
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testChessThreadSafety()
+{
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chessEnableThreadSafety(chess) == CHESS_SUCCESS);
+    TournamentThread threads[THREADS_AMOUNT];
+    pthread_t thread_ids[THREADS_AMOUNT];
+    for (int i = 0; i < THREADS_AMOUNT; i++)
+    {
+        ASSERT_TEST(chessAddTournament(chess, i + 1, THREAD_PLAYERS, "London") == CHESS_SUCCESS);
+        ASSERT_TEST(chessAddTournament(expected, i + 1, THREAD_PLAYERS, "London") == CHESS_SUCCESS);
+        threads[i].chess = chess;
+        threads[i].tournament_id = i + 1;
+        ASSERT_TEST(pthread_create(&thread_ids[i], NULL, tournamentThread, &threads[i]) == 0);
+    }
+    for (int i = 0; i < THREADS_AMOUNT; i++)
+    {
+        pthread_join(thread_ids[i], NULL);
+        ASSERT_TEST(threads[i].succeeded);
+        bool succeeded;
+        addTournamentGames(expected, i + 1, &succeeded);
+        ASSERT_TEST(succeeded);
+    }
+    ASSERT_TEST(sameSystems(chess, expected, THREADS_AMOUNT));
+
+    ASSERT_TEST(chessRemovePlayer(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(expected, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(expected, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(sameSystems(chess, expected, THREADS_AMOUNT));
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+/*The functions for the tests should be added here*/
+bool (*tests[]) (void) = {
+                      testChessRemoveBothPlayersOfGame,
+                      testChessAddGames,
+                      testChessSnapshotRoundTrip,
+                      testChessRecoverFromLog,
+                      testChessRecoverTornLog,
+                      testChessImportGamesFile,
+                      testChessThreadSafety
+};
+
+/*The names of the test functions should be added here*/
+const char* testNames[] = {
+                           "testChessRemoveBothPlayersOfGame",
+                           "testChessAddGames",
+                           "testChessSnapshotRoundTrip",
+                           "testChessRecoverFromLog",
+                           "testChessRecoverTornLog",
+                           "testChessImportGamesFile",
+                           "testChessThreadSafety"
+};
+
+int main(int argc, char *argv[])
+{
+    if (argc == 1)
+    {
+        for (int test_idx = 0; test_idx < NUMBER_TESTS; test_idx++)
+        {
+            RUN_TEST(tests[test_idx], testNames[test_idx]);
+        }
+        return tests_failed;
+    }
+    if (argc != 2)
+    {
+        fprintf(stdout, "Usage: chessSystemTests <test index>\n");
+        return 0;
+    }
+
+    int test_idx = strtol(argv[1], NULL, 10);
+    if (test_idx < 1 || test_idx > NUMBER_TESTS)
+    {
+        fprintf(stderr, "Invalid test index %d\n", test_idx);
+        return 0;
+    }
+
+    RUN_TEST(tests[test_idx - 1], testNames[test_idx - 1]);
+    return tests_failed;
+}
@@ -0,0 +1,42 @@
+#ifndef TEST_UTILITIES_H_
+#define TEST_UTILITIES_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * Macros for writing the tests of a module: each test is a bool(void) function
+ * built of ASSERT_TEST checks, and main runs the tests by RUN_TEST
+ */
+
+/** Amount of tests that failed so far(main returns it) */
+static int tests_failed = 0;
+
+/** Fails the running test(returns false from it) if an expression is false */
+#define ASSERT_TEST(expr)                                                       \
+    do                                                                          \
+    {                                                                           \
+        if (!(expr))                                                            \
+        {                                                                       \
+            printf("\nAssertion failed at %s:%d %s ", __FILE__, __LINE__, #expr); \
+            return false;                                                       \
+        }                                                                       \
+    } while (0)
+
+/** Runs a test and prints its result */
+#define RUN_TEST(test, name)                                                    \
+    do                                                                          \
+    {                                                                           \
+        printf("Running %s ... ", name);                                        \
+        if (test())                                                             \
+        {                                                                       \
+            printf("[OK]\n");                                                   \
+        }                                                                       \
+        else                                                                    \
+        {                                                                       \
+            printf("[Failed]\n");                                               \
+            tests_failed++;                                                     \
+        }                                                                       \
+    } while (0)
+
+#endif